@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace bench {
+    // Create a psi_t for a recording with the given number of probes and
+    // samples, split into as many .psd files as needed
+    inline pslib::v1_0::psi_t make_psi(const std::string& base_name,
+        size_t probe_count, size_t sample_count)
+    {
+        auto psi = pslib::v1_0::psi_t();
+        {
+            psi.filename = "./" + base_name + ".psi";
+            psi.checksum = 0;
+            psi.sampling_rate = 100000; // 100 kHz
+            psi.sampling_count = sample_count;
+
+            for (size_t i = 1; i <= probe_count; ++i) {
+                auto probe = pslib::v1_0::probe_t();
+                {
+                    double nan = std::numeric_limits< double >::quiet_NaN();
+                    probe.id = int64_t(i);
+                    probe.port = int64_t(i);
+                    probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                    probe.current_min = nan;
+                    probe.current_max = nan;
+                    probe.voltage_min = nan;
+                    probe.voltage_max = nan;
+                }
+                psi.probes.push_back(probe);
+            }
+
+            const auto capacity = pslib::v1_0::psd_sample_capacity(psi);
+            for (size_t offset = 0; offset < sample_count;
+                 offset += capacity) {
+                auto psd = pslib::v1_0::psd_t();
+                {
+                    psd.id = int64_t(psi.psds.size() + 1);
+                    psd.offset = offset > 0 ? int64_t(offset + 1) : 0;
+                    psd.data_count =
+                        int64_t(std::min(capacity, sample_count - offset));
+                    psd.event_count = 0;
+                }
+                psi.psds.push_back(psd);
+            }
+        }
+        return psi;
+    }
+
+    // Create synthetic samples for the whole recording of psi
+    inline pslib::v1_0::samples_t make_samples(const pslib::v1_0::psi_t& psi)
+    {
+        const auto probe_count = psi.probes.size();
+        auto samples = pslib::v1_0::samples_t(
+            psi, std::chrono::nanoseconds(0), psi.length());
+        {
+            for (size_t i = 0; i < psi.sampling_count; ++i) {
+                for (size_t j = 0; j < probe_count; ++j) {
+                    auto ds = pslib::v1_0::data_stream_t();
+                    {
+                        ds.current = double(i % 1000) / 1000.0 + double(j);
+                        ds.voltage = 3.3 + double(i % 7) / 100.0;
+                    }
+                    samples.values.push_back(ds);
+                }
+                for (size_t j = 0; j < (probe_count + 1); ++j) {
+                    auto e = pslib::v1_0::event_t();
+                    {
+                        e.data = (i % 100000 == 0) ? 0x8001 : 0;
+                    }
+                    samples.events.push_back(e);
+                }
+            }
+        }
+        return samples;
+    }
+
+    // Write a recording of the given size with synthetic data and return its
+    // (loaded) psi
+    inline pslib::v1_0::psi_t make_recording(const std::string& base_name,
+        size_t probe_count, size_t sample_count)
+    {
+        auto psi = make_psi(base_name, probe_count, sample_count);
+        pslib::v1_0::save_psi(psi, "./", base_name);
+        pslib::v1_0::save_samples(make_samples(psi), "./", base_name);
+        return pslib::v1_0::load_psi(psi.filename);
+    }
+
+    // Return the seconds elapsed while running f
+    template < typename F > inline double measure(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration< double >(stop - start).count();
+    }
+
+    // Read size bytes at data with independent accumulators and return a
+    // checksum, which bounds the throughput of any kernel over the same
+    // memory
+    inline uint64_t read_memory(const void* data, size_t size)
+    {
+        const auto bytes = static_cast< const char* >(data);
+        uint64_t x[ 4 ] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i + 4 * sizeof(uint64_t) <= size;
+             i += 4 * sizeof(uint64_t)) {
+            for (size_t j = 0; j < 4; ++j) {
+                uint64_t w;
+                std::memcpy(&w, bytes + i + j * sizeof(uint64_t), sizeof(w));
+                x[ j ] ^= w;
+            }
+        }
+        return x[ 0 ] ^ x[ 1 ] ^ x[ 2 ] ^ x[ 3 ];
+    }
+
+    inline double mib_per_s(size_t bytes, double seconds)
+    {
+        return double(bytes) / (1024.0 * 1024.0) / seconds;
+    }
+}
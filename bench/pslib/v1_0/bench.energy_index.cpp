@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+// StdLib
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+#include "bench.common.h"
+
+// Measure how long building the energy index of a recording takes with one
+// and with all hardware threads, and compare the energy of random ranges
+// taken from the index with streaming the same ranges from the .psd files.
+//
+// Usage: bench.energy_index [size in MiB = 512] [probes = 3] [queries = 20]
+//        [block size = 65536]
+int main(int argc, char* argv[])
+{
+    const size_t size_mib = argc > 1 ? std::stoul(argv[ 1 ]) : 512;
+    const size_t probe_count = argc > 2 ? std::stoul(argv[ 2 ]) : 3;
+    const size_t queries = argc > 3 ? std::stoul(argv[ 3 ]) : 20;
+    const uint64_t block_size = argc > 4
+                                    ? std::stoul(argv[ 4 ])
+                                    : pslib::v1_0::energy_index_block_size;
+
+    auto psi = bench::make_psi("bench.energy_index", probe_count, 1);
+    const auto record_size = pslib::v1_0::sample_size(psi);
+    const auto sample_count = size_mib * 1024ul * 1024ul / record_size;
+    auto shared_psi = pslib::v1_0::shared_psi_t(
+        bench::make_recording("bench.energy_index", probe_count, sample_count));
+    const auto bytes = sample_count * record_size;
+    std::cout << "Recording:    " << size_mib << " MiB, " << probe_count
+              << " probes, " << sample_count << " samples, blocks of "
+              << block_size << " samples" << std::endl;
+
+    pslib::v1_0::energy_index_t index;
+    for (size_t threads : { size_t(1), size_t(0) }) {
+        auto seconds = bench::measure([&] {
+            index = pslib::v1_0::build_energy_index(
+                shared_psi, block_size, threads);
+        });
+        std::cout << "Build (" << (threads == 0 ? "all" : "1")
+                  << " threads): " << seconds << " s, "
+                  << bench::mib_per_s(bytes, seconds) << " MiB/s"
+                  << std::endl;
+    }
+
+    // Random ranges of at least a tenth of the recording
+    std::mt19937_64 random(42);
+    const auto length = shared_psi->length().count();
+    std::vector< std::pair< std::chrono::nanoseconds,
+        std::chrono::nanoseconds > >
+        ranges;
+    for (size_t i = 0; i < queries; ++i) {
+        auto begin = int64_t(random() % uint64_t(length * 9 / 10));
+        auto end = begin + length / 10 +
+                   int64_t(random() % uint64_t(length - length / 10 - begin));
+        ranges.emplace_back(std::chrono::nanoseconds(begin),
+            std::chrono::nanoseconds(end));
+    }
+
+    double energy = 0.0;
+    auto streamed = bench::measure([&] {
+        for (const auto& range : ranges) {
+            energy += pslib::v1_0::probe_energy(
+                shared_psi, range.first, range.second)[ 0 ]
+                          .energy();
+        }
+    });
+    auto indexed = bench::measure([&] {
+        for (const auto& range : ranges) {
+            energy -= pslib::v1_0::indexed_probe_energy(
+                index, shared_psi, range.first, range.second)[ 0 ]
+                          .energy();
+        }
+    });
+    std::cout << "Streamed:     " << streamed / double(queries) * 1e3
+              << " ms per range" << std::endl;
+    std::cout << "Indexed:      " << indexed / double(queries) * 1e3
+              << " ms per range" << std::endl;
+    std::cout << "Difference:   " << energy << " J" << std::endl;
+
+    return EXIT_SUCCESS;
+}
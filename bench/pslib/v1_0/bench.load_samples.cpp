@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+#include "bench.common.h"
+
+// Compare the throughput of load_samples and load_samples_parallel with a
+// plain sequential read of the same .psd files.
+//
+// Usage: bench.load_samples [size in MiB = 512] [probes = 3]
+int main(int argc, char* argv[])
+{
+    const size_t size_mib = argc > 1 ? std::stoul(argv[ 1 ]) : 512;
+    const size_t probe_count = argc > 2 ? std::stoul(argv[ 2 ]) : 3;
+
+    auto psi = bench::make_psi("bench.load_samples", probe_count, 1);
+    const auto record_size = pslib::v1_0::sample_size(psi);
+    const auto sample_count = size_mib * 1024ul * 1024ul / record_size;
+    psi =
+        bench::make_recording("bench.load_samples", probe_count, sample_count);
+    const auto bytes = sample_count * record_size;
+    const auto shared_psi = pslib::v1_0::shared_psi_t(psi);
+
+    // Sequential read of the raw .psd data
+    std::vector< char > buffer(pslib::v1_0::psd_read_block_size);
+    auto raw_seconds = bench::measure([&] {
+        for (const auto& psd : psi.psds) {
+            std::ifstream psd_ifstream(
+                pslib::v1_0::psd_filename(psi, psd), std::ios::binary);
+            auto remaining = size_t(psd.data_count) * record_size;
+            while (psd_ifstream.good() && remaining > 0) {
+                const auto n = std::min(remaining, buffer.size());
+                psd_ifstream.read(buffer.data(), std::streamsize(n));
+                remaining -= n;
+            }
+        }
+    });
+
+    size_t loaded = 0;
+    auto load_seconds = bench::measure([&] {
+        auto samples = pslib::v1_0::load_samples(shared_psi);
+        loaded = samples.size();
+    });
+    if (loaded != sample_count) {
+        std::cout << "Loaded " << loaded << " of " << sample_count
+                  << " samples" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t loaded_parallel = 0;
+    auto parallel_seconds = bench::measure([&] {
+        auto samples = pslib::v1_0::load_samples_parallel(shared_psi);
+        loaded_parallel = samples.size();
+    });
+    if (loaded_parallel != sample_count) {
+        std::cout << "Loaded " << loaded_parallel << " of " << sample_count
+                  << " samples in parallel" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Recording:    " << size_mib << " MiB, " << probe_count
+              << " probes, " << sample_count << " samples" << std::endl;
+    std::cout << "Raw read:     " << bench::mib_per_s(bytes, raw_seconds)
+              << " MiB/s" << std::endl;
+    std::cout << "load_samples: " << bench::mib_per_s(bytes, load_seconds)
+              << " MiB/s" << std::endl;
+    std::cout << "load_samples_parallel ("
+              << std::thread::hardware_concurrency() << " threads): "
+              << bench::mib_per_s(bytes, parallel_seconds) << " MiB/s"
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
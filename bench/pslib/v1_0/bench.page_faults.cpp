@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+// Posix
+#include <sys/resource.h>
+
+#include "bench.common.h"
+
+namespace {
+    // Minor page faults of this process so far
+    long minor_faults()
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt;
+    }
+
+    // Load the recording count times into samples allocated by
+    // make_resource() and report time and page faults
+    template < typename F >
+    void report(const std::string& name, const pslib::v1_0::psi_t& psi,
+        size_t count, F&& make_resource)
+    {
+        const auto bytes = psi.sampling_count * pslib::v1_0::sample_size(psi);
+        size_t checksum = 0;
+        const auto faults = minor_faults();
+        auto seconds = bench::measure([&] {
+            for (size_t i = 0; i < count; ++i) {
+                auto samples = pslib::v1_0::load_samples(psi,
+                    std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1),
+                    make_resource());
+                checksum += samples.size();
+            }
+        });
+        std::cout << name << bench::mib_per_s(bytes * count, seconds)
+                  << " MiB/s, " << (minor_faults() - faults) / long(count)
+                  << " page faults per load (" << checksum / count
+                  << " samples)" << std::endl;
+    }
+}
+
+// Compare the page faults and throughput of repeated loads into memory from
+// the default allocator and from a sample_arena which is reused between the
+// loads.
+//
+// Usage: bench.page_faults [size in MiB = 256] [loads = 8] [probes = 3]
+int main(int argc, char* argv[])
+{
+    const size_t size_mib = argc > 1 ? std::stoul(argv[ 1 ]) : 256;
+    const size_t loads = argc > 2 ? std::stoul(argv[ 2 ]) : 8;
+    const size_t probe_count = argc > 3 ? std::stoul(argv[ 3 ]) : 3;
+
+    auto psi = bench::make_psi("bench.page_faults", probe_count, 1);
+    const auto sample_count =
+        size_mib * 1024ul * 1024ul / pslib::v1_0::sample_size(psi);
+    psi = bench::make_recording("bench.page_faults", probe_count, sample_count);
+    std::cout << "Recording:    " << size_mib << " MiB, " << probe_count
+              << " probes, " << sample_count << " samples, " << loads
+              << " loads" << std::endl;
+
+    report("Default:      ", psi, loads,
+        [] { return std::pmr::get_default_resource(); });
+
+    using pslib::v1_0::HUGE_PAGES;
+    for (auto mode :
+        { HUGE_PAGES::NONE, HUGE_PAGES::TRANSPARENT, HUGE_PAGES::EXPLICIT }) {
+        auto arena = pslib::v1_0::sample_arena(mode);
+        std::string name = mode == HUGE_PAGES::NONE
+                               ? "Arena:        "
+                               : mode == HUGE_PAGES::TRANSPARENT
+                                     ? "Arena (THP):  "
+                                     : "Arena (huge): ";
+        report(name, psi, loads, [&] {
+            arena.reset();
+            return &arena;
+        });
+        if (mode == HUGE_PAGES::EXPLICIT) {
+            std::cout << "              " << arena.huge_page_blocks()
+                      << " blocks with explicit huge pages" << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+// StdLib
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+#include "bench.common.h"
+
+// Compare the throughput of the statistics kernels of every instruction set
+// supported by the CPU with a plain read of the same memory, which bounds
+// what any kernel can reach.
+//
+// Usage: bench.probe_statistics [size in MiB = 512] [probes = 3] [runs = 5]
+int main(int argc, char* argv[])
+{
+    const size_t size_mib = argc > 1 ? std::stoul(argv[ 1 ]) : 512;
+    const size_t probe_count = argc > 2 ? std::stoul(argv[ 2 ]) : 3;
+    const size_t runs = argc > 3 ? std::stoul(argv[ 3 ]) : 5;
+
+    const auto sample_size =
+        probe_count * sizeof(pslib::v1_0::data_stream_t);
+    const auto sample_count = size_mib * 1024ul * 1024ul / sample_size;
+    auto psi =
+        bench::make_psi("bench.probe_statistics", probe_count, sample_count);
+    auto samples = bench::make_samples(psi);
+    const auto bytes =
+        samples.values.size() * sizeof(pslib::v1_0::data_stream_t);
+    std::cout << "Samples:      " << size_mib << " MiB, " << probe_count
+              << " probes, " << sample_count << " samples, best of " << runs
+              << " runs" << std::endl;
+
+    // Report the best throughput of runs calls to f
+    auto report = [&](const std::string& name, auto&& f) {
+        double best = 0.0;
+        for (size_t i = 0; i < runs; ++i) {
+            best = std::max(best, bench::mib_per_s(bytes, bench::measure(f)));
+        }
+        std::cout << name << best << " MiB/s" << std::endl;
+    };
+
+    uint64_t checksum = 0;
+    report("Memory read:  ", [&] {
+        checksum += bench::read_memory(samples.values.data(), bytes);
+    });
+
+    using pslib::v1_0::SIMD_ISA;
+    const std::pair< SIMD_ISA, std::string > isas[] = {
+        { SIMD_ISA::SCALAR, "Scalar:       " },
+        { SIMD_ISA::SSE2, "SSE2:         " },
+        { SIMD_ISA::AVX2, "AVX2:         " },
+        { SIMD_ISA::AVX512, "AVX-512:      " }
+    };
+    double mean = 0.0;
+    for (const auto& isa : isas) {
+        if (!pslib::v1_0::simd_isa_supported(isa.first)) {
+            std::cout << isa.second << "not supported" << std::endl;
+            continue;
+        }
+        report(isa.second, [&] {
+            auto stats = pslib::v1_0::probe_statistics(
+                samples, pslib::v1_0::NAN_POLICY::SKIP, isa.first);
+            mean += stats[ 0 ].current.mean();
+        });
+    }
+
+    auto soa = pslib::v1_0::to_soa_samples(samples);
+    report("Columns:      ", [&] {
+        auto stats = pslib::v1_0::probe_statistics(soa);
+        mean += stats[ 0 ].current.mean();
+    });
+
+    // Keep the results alive
+    if (checksum == 1 && mean == 0.0) {
+        std::cout << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+#include "bench.common.h"
+
+// Compare the throughput of save_samples and the mapped_psd_writer with a
+// plain sequential write of the same amount of data.
+//
+// Usage: bench.save_samples [size in MiB = 512] [probes = 3]
+int main(int argc, char* argv[])
+{
+    const size_t size_mib = argc > 1 ? std::stoul(argv[ 1 ]) : 512;
+    const size_t probe_count = argc > 2 ? std::stoul(argv[ 2 ]) : 3;
+
+    auto psi = bench::make_psi("bench.save_samples", probe_count, 1);
+    const auto record_size = pslib::v1_0::sample_size(psi);
+    const auto sample_count = size_mib * 1024ul * 1024ul / record_size;
+    psi = bench::make_psi("bench.save_samples", probe_count, sample_count);
+    pslib::v1_0::save_psi(psi, "./", "bench.save_samples");
+    auto samples = bench::make_samples(psi);
+    const auto bytes = sample_count * record_size;
+
+    // Sequential write of the same amount of raw data
+    std::vector< char > buffer(pslib::v1_0::psd_write_block_size);
+    auto raw_seconds = bench::measure([&] {
+        std::ofstream raw_file("./bench.save_samples.raw",
+            std::ios::binary | std::ios::trunc);
+        for (size_t written = 0; written < bytes;
+             written += buffer.size()) {
+            raw_file.write(buffer.data(),
+                std::streamsize(std::min(buffer.size(), bytes - written)));
+        }
+        raw_file.flush();
+    });
+
+    auto save_seconds = bench::measure([&] {
+        pslib::v1_0::save_samples(samples, "./", "bench.save_samples");
+    });
+
+    // Encode directly into the mapped .psd files
+    auto mapped_seconds = bench::measure([&] {
+        auto writer = pslib::v1_0::mapped_psd_writer(
+            psi, "./", "bench.save_samples_mapped");
+        writer.write(
+            samples.values.data(), samples.events.data(), samples.size());
+        writer.close();
+    });
+
+    std::cout << "Recording:    " << size_mib << " MiB, " << probe_count
+              << " probes, " << sample_count << " samples" << std::endl;
+    std::cout << "Raw write:    " << bench::mib_per_s(bytes, raw_seconds)
+              << " MiB/s" << std::endl;
+    std::cout << "save_samples: " << bench::mib_per_s(bytes, save_seconds)
+              << " MiB/s" << std::endl;
+    std::cout << "mapped write: " << bench::mib_per_s(bytes, mapped_seconds)
+              << " MiB/s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
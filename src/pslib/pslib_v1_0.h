@@ -23,17 +23,73 @@
 #pragma once
 
 // Own
+#include "pslib/v1_0/async_psd_writer.h"
+#include "pslib/v1_0/build_energy_index.h"
+#include "pslib/v1_0/build_event_index.h"
+#include "pslib/v1_0/build_psx.h"
+#include "pslib/v1_0/column_statistics.h"
+#include "pslib/v1_0/compact_samples_t.h"
+#include "pslib/v1_0/compensated_sum_t.h"
 #include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/energy_index_t.h"
+#include "pslib/v1_0/energy_t.h"
+#include "pslib/v1_0/envelope_t.h"
+#include "pslib/v1_0/event_index_t.h"
 #include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/find_events.h"
+#include "pslib/v1_0/indexed_iterator.h"
+#include "pslib/v1_0/indexed_probe_energy.h"
+#include "pslib/v1_0/load_compact_samples.h"
+#include "pslib/v1_0/load_energy_index.h"
+#include "pslib/v1_0/load_envelope.h"
+#include "pslib/v1_0/load_event_index.h"
 #include "pslib/v1_0/load_psi.h"
+#include "pslib/v1_0/load_psx.h"
 #include "pslib/v1_0/load_samples.h"
+#include "pslib/v1_0/load_samples_parallel.h"
+#include "pslib/v1_0/load_soa_samples.h"
+#include "pslib/v1_0/map_samples.h"
+#include "pslib/v1_0/mapped_psd_writer.h"
+#include "pslib/v1_0/mapped_records_t.h"
+#include "pslib/v1_0/mapped_sample_t.h"
+#include "pslib/v1_0/mapped_samples_t.h"
+#include "pslib/v1_0/power_sums.h"
+#include "pslib/v1_0/prefetch_sample_reader.h"
+#include "pslib/v1_0/probe_energy.h"
 #include "pslib/v1_0/probe_kind.h"
+#include "pslib/v1_0/probe_statistics.h"
 #include "pslib/v1_0/probe_t.h"
+#include "pslib/v1_0/projection_t.h"
 #include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
 #include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psd_writer.h"
 #include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/psx_statistics.h"
+#include "pslib/v1_0/psx_t.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/run_workers.h"
+#include "pslib/v1_0/sample_allocator.h"
+#include "pslib/v1_0/sample_arena.h"
+#include "pslib/v1_0/sample_block_t.h"
+#include "pslib/v1_0/sample_reader.h"
 #include "pslib/v1_0/sample_t.h"
+#include "pslib/v1_0/sample_view_t.h"
 #include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/save_energy_index.h"
+#include "pslib/v1_0/save_event_index.h"
 #include "pslib/v1_0/save_psi.h"
+#include "pslib/v1_0/save_psx.h"
 #include "pslib/v1_0/save_samples.h"
+#include "pslib/v1_0/save_samples_parallel.h"
+#include "pslib/v1_0/save_soa_samples.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/soa_samples_t.h"
+#include "pslib/v1_0/span_t.h"
+#include "pslib/v1_0/statistics_t.h"
+#include "pslib/v1_0/update_event_index.h"
+#include "pslib/v1_0/update_psx.h"
+#include "pslib/v1_0/update_samples.h"
 #include "pslib/v1_0/validate_psi.h"
+#include "pslib/v1_0/write_psd.h"
@@ -0,0 +1,354 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_writer.h"
+#include "pslib/v1_0/psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    class async_psd_writer_stats_t {
+        public:
+        // Batches accepted by write()/try_write(), writes of more than
+        // batch_size samples count once per slot they occupy
+        uint64_t pushed_batches;
+        // Batches written to the .psd files by the I/O thread
+        uint64_t written_batches;
+        // Batches (and their samples) rejected by try_write() because the
+        // queue was full
+        uint64_t dropped_batches;
+        uint64_t dropped_samples;
+        // Number of times write() had to wait for the I/O thread
+        uint64_t backpressure_waits;
+    };
+
+    // Front end of a psd_writer which hands batches of samples from a single
+    // producer thread to a dedicated I/O thread through a lock-free bounded
+    // ring buffer, so the producer never blocks on disk I/O unless it asks
+    // to.
+    class async_psd_writer {
+        private:
+        class batch_t {
+            public:
+            std::vector< data_stream_t > values;
+            std::vector< event_t > events;
+            size_t count;
+        };
+
+        psd_writer m_writer;
+        size_t m_probe_count;
+        // Maximum number of samples per slot
+        size_t m_batch_size;
+        std::vector< batch_t > m_slots;
+        // Number of batches pushed by the producer
+        std::atomic< uint64_t > m_head;
+        // Number of batches written by the I/O thread
+        std::atomic< uint64_t > m_tail;
+        std::atomic< uint64_t > m_dropped_batches;
+        std::atomic< uint64_t > m_dropped_samples;
+        std::atomic< uint64_t > m_backpressure_waits;
+        std::atomic< bool > m_stop;
+        // Set once m_error holds an error, so the producer only takes the
+        // lock to rethrow it
+        std::atomic< bool > m_failed;
+        // Set while the I/O thread / producer waits (or is about to wait)
+        // on its condition variable. The other side only takes the lock to
+        // wake it up if the flag is set.
+        std::atomic< bool > m_io_waiting;
+        std::atomic< bool > m_producer_waiting;
+
+        // Only used to sleep and wake up, the ring itself is lock-free
+        std::mutex m_mutex;
+        std::condition_variable m_io_cv;
+        std::condition_variable m_producer_cv;
+        // Sequence number up to which a sync was requested / is done
+        uint64_t m_sync_requested;
+        uint64_t m_synced;
+        std::exception_ptr m_error;
+        bool m_closed;
+        std::thread m_thread;
+
+        public:
+        // queue_capacity is the number of batches which may wait for the I/O
+        // thread, each slot reserves space for batch_size samples up front.
+        // Larger writes are split across several slots, so the producer
+        // never allocates.
+        inline async_psd_writer(const psi_t& psi, const std::string& directory,
+            const std::string& base_name, size_t queue_capacity = 64,
+            size_t batch_size = 4096, size_t psd_capacity = 0)
+            : m_writer{ psi, directory, base_name, psd_capacity }
+            , m_probe_count{ psi.probes.size() }
+            , m_batch_size{ std::max(batch_size, size_t(1)) }
+            , m_slots(std::max(queue_capacity, size_t(1)))
+            , m_head{ 0 }
+            , m_tail{ 0 }
+            , m_dropped_batches{ 0 }
+            , m_dropped_samples{ 0 }
+            , m_backpressure_waits{ 0 }
+            , m_stop{ false }
+            , m_failed{ false }
+            , m_io_waiting{ false }
+            , m_producer_waiting{ false }
+            , m_sync_requested{ 0 }
+            , m_synced{ 0 }
+            , m_closed{ false }
+        {
+            for (auto& slot : m_slots) {
+                slot.values.reserve(m_batch_size * m_probe_count);
+                slot.events.reserve(m_batch_size * (m_probe_count + 1));
+                slot.count = 0;
+            }
+            m_thread = std::thread([this]() { this->drain(); });
+        }
+
+        async_psd_writer(const async_psd_writer&) = delete;
+        async_psd_writer& operator=(const async_psd_writer&) = delete;
+
+        inline ~async_psd_writer()
+        {
+            try {
+                this->close();
+            }
+            catch (...) {
+            }
+        }
+
+        // Queue count samples without ever blocking. Returns false (and
+        // counts the batch as dropped) if the queue hasn't enough free slots
+        // for all of them, so a batch is either queued completely or not at
+        // all.
+        inline bool try_write(
+            const data_stream_t* values, const event_t* events, size_t count)
+        {
+            if (m_closed) {
+                throw std::runtime_error(
+                    "Unable to write to closed " + m_writer.psi().filename);
+            }
+            this->check();
+            const auto head = m_head.load(std::memory_order_relaxed);
+            const auto used = head - m_tail.load(std::memory_order_acquire);
+            const auto needed = (count + m_batch_size - 1) / m_batch_size;
+            if (m_slots.size() - used < needed) {
+                m_dropped_batches.fetch_add(1, std::memory_order_relaxed);
+                m_dropped_samples.fetch_add(count, std::memory_order_relaxed);
+                return false;
+            }
+            while (count > 0) {
+                const auto n = std::min(count, m_batch_size);
+                this->push(
+                    m_head.load(std::memory_order_relaxed), values, events, n);
+                values += n * m_probe_count;
+                events += n * (m_probe_count + 1);
+                count -= n;
+            }
+            return true;
+        }
+
+        // Queue count samples, waiting for the I/O thread if the queue is
+        // full
+        inline void write(
+            const data_stream_t* values, const event_t* events, size_t count)
+        {
+            if (m_closed) {
+                throw std::runtime_error(
+                    "Unable to write to closed " + m_writer.psi().filename);
+            }
+            this->check();
+            while (count > 0) {
+                const auto n = std::min(count, m_batch_size);
+                const auto head = m_head.load(std::memory_order_relaxed);
+                if (head - m_tail.load(std::memory_order_acquire) >=
+                    m_slots.size()) {
+                    m_backpressure_waits.fetch_add(
+                        1, std::memory_order_relaxed);
+                    std::unique_lock< std::mutex > lock(m_mutex);
+                    m_producer_waiting = true;
+                    m_producer_cv.wait(lock, [&]() {
+                        return head - m_tail.load() < m_slots.size() ||
+                               m_failed;
+                    });
+                    m_producer_waiting = false;
+                    lock.unlock();
+                    this->check();
+                }
+                this->push(head, values, events, n);
+                values += n * m_probe_count;
+                events += n * (m_probe_count + 1);
+                count -= n;
+            }
+        }
+
+        // Wait until all samples queued so far were written and reached the
+        // disk, including the .psi file describing them (see
+        // psd_writer::sync())
+        inline void flush()
+        {
+            if (m_closed) {
+                throw std::runtime_error(
+                    "Unable to flush closed " + m_writer.psi().filename);
+            }
+            this->check();
+            std::unique_lock< std::mutex > lock(m_mutex);
+            const auto target = m_head.load(std::memory_order_relaxed);
+            m_sync_requested = std::max(m_sync_requested, target);
+            m_io_cv.notify_one();
+            m_producer_cv.wait(
+                lock, [&]() { return m_synced >= target || m_failed; });
+            lock.unlock();
+            this->check();
+        }
+
+        inline async_psd_writer_stats_t stats() const
+        {
+            auto stats = pslib::v1_0::async_psd_writer_stats_t();
+            {
+                stats.pushed_batches = m_head.load();
+                stats.written_batches = m_tail.load();
+                stats.dropped_batches = m_dropped_batches.load();
+                stats.dropped_samples = m_dropped_samples.load();
+                stats.backpressure_waits = m_backpressure_waits.load();
+            }
+            return stats;
+        }
+
+        // Write all queued samples, stop the I/O thread and write the .psi
+        // file
+        inline const psi_t& close()
+        {
+            if (m_closed) {
+                return m_writer.psi();
+            }
+            m_closed = true;
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_stop = true;
+            }
+            m_io_cv.notify_one();
+            m_thread.join();
+            this->check();
+            return m_writer.close();
+        }
+
+        private:
+        inline void check()
+        {
+            if (!m_failed.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::lock_guard< std::mutex > lock(m_mutex);
+            std::rethrow_exception(m_error);
+        }
+
+        // Wake up the I/O thread if it is waiting (or about to wait) for
+        // work. The flag and the queue indices are sequentially consistent,
+        // so either the I/O thread sees the new state before it waits or
+        // this sees the flag and notifies under the lock.
+        inline void wake_io()
+        {
+            if (m_io_waiting) {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_io_cv.notify_one();
+            }
+        }
+
+        // Same as wake_io() for a producer waiting for a free slot
+        inline void wake_producer()
+        {
+            if (m_producer_waiting) {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_producer_cv.notify_all();
+            }
+        }
+
+        inline void push(uint64_t head, const data_stream_t* values,
+            const event_t* events, size_t count)
+        {
+            auto& slot = m_slots[ head % m_slots.size() ];
+            slot.values.assign(values, values + count * m_probe_count);
+            slot.events.assign(events, events + count * (m_probe_count + 1));
+            slot.count = count;
+            m_head.store(head + 1);
+            this->wake_io();
+        }
+
+        inline void drain()
+        {
+            try {
+                while (true) {
+                    auto tail = m_tail.load(std::memory_order_relaxed);
+                    const auto head = m_head.load(std::memory_order_acquire);
+                    for (; tail < head; ++tail) {
+                        const auto& slot = m_slots[ tail % m_slots.size() ];
+                        m_writer.write(
+                            slot.values.data(), slot.events.data(), slot.count);
+                        m_tail.store(tail + 1);
+                        this->wake_producer();
+                    }
+
+                    std::unique_lock< std::mutex > lock(m_mutex);
+                    if (m_sync_requested > m_synced &&
+                        tail >= m_sync_requested) {
+                        const auto target = m_sync_requested;
+                        lock.unlock();
+                        m_writer.sync();
+                        lock.lock();
+                        m_synced = target;
+                        m_producer_cv.notify_all();
+                    }
+                    if (m_stop &&
+                        m_head.load(std::memory_order_acquire) == tail) {
+                        break;
+                    }
+                    m_io_waiting = true;
+                    m_io_cv.wait(lock, [&]() {
+                        return m_head.load() != tail || m_stop ||
+                               m_sync_requested > m_synced;
+                    });
+                    m_io_waiting = false;
+                }
+            }
+            catch (...) {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_error = std::current_exception();
+                m_failed.store(true, std::memory_order_release);
+            }
+            std::lock_guard< std::mutex > lock(m_mutex);
+            m_producer_cv.notify_all();
+        }
+    };
+}
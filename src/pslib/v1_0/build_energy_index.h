@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/energy_index_t.h"
+#include "pslib/v1_0/load_samples_parallel.h"
+#include "pslib/v1_0/power_sums.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/run_workers.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Default number of samples per block of an energy index
+    constexpr uint64_t energy_index_block_size = 65536;
+
+    // Turn the block totals in cumulative[ (b + 1) * probe_count + p ] into
+    // the totals of all blocks up to b (an inclusive scan, entry 0 stays
+    // untouched) on thread_count threads. Every thread sums up its segment
+    // of blocks, the segment totals are scanned and every thread then scans
+    // its segment starting at the total of the segments before.
+    inline void scan_cumulative_energy(
+        std::vector< cumulative_energy_t >& cumulative, size_t probe_count,
+        size_t thread_count)
+    {
+        const size_t block_count =
+            probe_count > 0 ? cumulative.size() / probe_count - 1 : 0;
+        thread_count = std::min(std::max(thread_count, size_t(1)), block_count);
+        if (thread_count == 0) {
+            return;
+        }
+        const size_t segment = (block_count + thread_count - 1) / thread_count;
+        auto segment_first = [&](size_t t) {
+            return 1 + std::min(t * segment, block_count);
+        };
+
+        std::vector< cumulative_energy_t > totals(thread_count * probe_count);
+        pslib::v1_0::run_workers(thread_count, [&](size_t t) {
+            for (auto b = segment_first(t); b < segment_first(t + 1); ++b) {
+                for (size_t p = 0; p < probe_count; ++p) {
+                    totals[ t * probe_count + p ].add(
+                        cumulative[ b * probe_count + p ]);
+                }
+            }
+        });
+
+        // Exclusive scan of the segment totals
+        std::vector< cumulative_energy_t > offsets(thread_count * probe_count);
+        for (size_t t = 1; t < thread_count; ++t) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                offsets[ t * probe_count + p ] =
+                    offsets[ (t - 1) * probe_count + p ];
+                offsets[ t * probe_count + p ].add(
+                    totals[ (t - 1) * probe_count + p ]);
+            }
+        }
+
+        pslib::v1_0::run_workers(thread_count, [&](size_t t) {
+            std::vector< cumulative_energy_t > running(
+                offsets.begin() + std::ptrdiff_t(t * probe_count),
+                offsets.begin() + std::ptrdiff_t((t + 1) * probe_count));
+            for (auto b = segment_first(t); b < segment_first(t + 1); ++b) {
+                for (size_t p = 0; p < probe_count; ++p) {
+                    auto& entry = cumulative[ b * probe_count + p ];
+                    running[ p ].add(entry);
+                    entry = running[ p ];
+                }
+            }
+        });
+    }
+
+    // Build the energy index of a recording with blocks of block_size
+    // samples. The power sums of the blocks are computed from the .psd files
+    // by thread_count workers (each reading runs of blocks of roughly
+    // psd_parallel_chunk_size bytes) and then turned into cumulative sums
+    // with a parallel scan. A thread_count of 0 uses one worker per hardware
+    // thread.
+    inline energy_index_t build_energy_index(const shared_psi_t& shared_psi,
+        uint64_t block_size = energy_index_block_size, size_t thread_count = 0)
+    {
+        const psi_t& psi = *shared_psi;
+        if (block_size == 0) {
+            throw std::runtime_error("Invalid energy index block size of 0");
+        }
+        const size_t probe_count = psi.probes.size();
+        if (probe_count == 0) {
+            throw std::runtime_error("No probes in " + psi.filename);
+        }
+
+        auto index = pslib::v1_0::energy_index_t();
+        {
+            index.checksum = psi.checksum;
+            index.sampling_count = psi.sampling_count;
+            index.data_count = pslib::v1_0::psd_sample_count(psi);
+            index.probe_count = probe_count;
+            index.revision = psi.revision;
+            index.block_size = block_size;
+        }
+        const auto block_count =
+            size_t((index.data_count + block_size - 1) / block_size);
+        index.cumulative.resize((block_count + 1) * probe_count);
+
+        if (thread_count == 0) {
+            thread_count = std::max(size_t(std::thread::hardware_concurrency()),
+                size_t(1));
+        }
+        const auto task_blocks = std::max(psd_parallel_chunk_size /
+                                              (size_t(block_size) *
+                                                  shared_psi.record_size()),
+            size_t(1));
+        const auto task_count = (block_count + task_blocks - 1) / task_blocks;
+
+        // Power sums of the blocks
+        std::atomic< size_t > next_task{ 0 };
+        std::atomic< size_t > read{ 0 };
+        pslib::v1_0::run_workers(
+            std::min(thread_count, task_count), [&](size_t) {
+                std::vector< compensated_sum_t > sums(probe_count);
+                std::vector< uint64_t > nan_counts(probe_count);
+                for (auto t = next_task++; t < task_count; t = next_task++) {
+                    const auto first = index.position(t * task_blocks);
+                    const auto last = index.position((t + 1) * task_blocks);
+                    auto reader = pslib::v1_0::sample_reader(shared_psi,
+                        int64_t(first) * shared_psi.interval(),
+                        int64_t(last - 1) * shared_psi.interval(),
+                        size_t(block_size));
+                    while (auto block = reader.next()) {
+                        std::fill(
+                            sums.begin(), sums.end(), compensated_sum_t());
+                        std::fill(nan_counts.begin(), nan_counts.end(), 0);
+                        pslib::v1_0::add_power_sums(
+                            reinterpret_cast< const double* >(
+                                block->values.data()),
+                            block->size(), probe_count, sums.data(),
+                            nan_counts.data(), NAN_POLICY::SKIP);
+                        const auto b = block->first / size_t(block_size);
+                        for (size_t p = 0; p < probe_count; ++p) {
+                            auto& entry =
+                                index.cumulative[ (b + 1) * probe_count + p ];
+                            entry.power_sum = sums[ p ];
+                            entry.nan_count = nan_counts[ p ];
+                        }
+                        read += block->size();
+                    }
+                }
+            });
+        if (read != index.data_count) {
+            throw std::runtime_error("Expected " +
+                                     std::to_string(index.data_count) +
+                                     " samples but only got " +
+                                     std::to_string(read) + " for " +
+                                     psi.filename);
+        }
+
+        pslib::v1_0::scan_cumulative_energy(
+            index.cumulative, probe_count, thread_count);
+        return index;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/event_index_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace pslib::v1_0 {
+    // Append an event_occurrence_t for every occured event in events, where
+    // events[ 0 ] is the first event of sample first
+    inline void scan_events(const event_t* events, size_t count,
+        size_t slot_count, uint64_t first,
+        std::vector< event_occurrence_t >& occurrences)
+    {
+        auto add = [&](size_t k) {
+            if ((events[ k ].data & 0x8000) != 0) {
+                occurrences.push_back(event_occurrence_t{
+                    first + k / slot_count, uint16_t(k % slot_count),
+                    uint16_t(events[ k ].data & 0x7FFF), 0 });
+            }
+        };
+
+        size_t k = 0;
+#if defined(__SSE2__)
+        // Events are rare, so test the MSBs of 8 events at once and only look
+        // at single events if any of them is set
+        for (; k + 8 <= count; k += 8) {
+            auto block = _mm_loadu_si128(
+                reinterpret_cast< const __m128i* >(events + k));
+            if ((_mm_movemask_epi8(block) & 0xAAAA) == 0) {
+                continue;
+            }
+            for (size_t j = k; j < k + 8; ++j) {
+                add(j);
+            }
+        }
+#endif
+        for (; k < count; ++k) {
+            add(k);
+        }
+    }
+
+    // Build the event index of a recording by streaming its .psd files once
+    inline event_index_t build_event_index(const shared_psi_t& shared_psi)
+    {
+        const psi_t& psi = *shared_psi;
+        auto index = pslib::v1_0::event_index_t();
+        {
+            index.checksum = psi.checksum;
+            index.sampling_count = psi.sampling_count;
+            index.data_count = pslib::v1_0::psd_sample_count(psi);
+            index.probe_count = psi.probes.size();
+            index.revision = psi.revision;
+        }
+
+        const auto slot_count = psi.probes.size() + 1;
+        auto reader = pslib::v1_0::sample_reader(shared_psi);
+        while (auto block = reader.next()) {
+            pslib::v1_0::scan_events(block->events.data(),
+                block->events.size(), slot_count, block->first,
+                index.occurrences);
+        }
+        return index;
+    }
+}
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/probe_statistics.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/psx_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Summarise the level 0 blocks [first_block, first_block + block_count)
+    // of a recording into level (block_count * probe count statistics) by
+    // streaming their samples from the .psd files. Returns the number of
+    // samples read.
+    inline size_t summarize_psx_blocks(const shared_psi_t& shared_psi,
+        uint64_t block_size, size_t first_block, size_t block_count,
+        probe_statistics_t* level)
+    {
+        const size_t probe_count = shared_psi.probe_count();
+        const auto interval = shared_psi.interval();
+        const auto first = first_block * size_t(block_size);
+        const auto last =
+            std::min((first_block + block_count) * size_t(block_size),
+                pslib::v1_0::psd_sample_count(*shared_psi));
+        if (first >= last) {
+            return 0;
+        }
+        auto reader = pslib::v1_0::sample_reader(shared_psi,
+            int64_t(first) * interval, int64_t(last - 1) * interval,
+            size_t(block_size) * 64);
+        size_t read = 0;
+        while (auto block = reader.next()) {
+            // Add the runs of samples within the same level 0 block at once
+            for (size_t i = 0; i < block->size();) {
+                const auto b = (block->first + i) / block_size;
+                const auto n = std::min(block->size() - i,
+                    size_t((b + 1) * block_size - (block->first + i)));
+                pslib::v1_0::add_probe_statistics(
+                    block->values.data() + i * probe_count, n,
+                    level + (b - first_block) * probe_count, probe_count);
+                i += n;
+            }
+            read += block->size();
+        }
+        return read;
+    }
+
+    // Summarise below_count blocks of a level, starting at an even block,
+    // into the (below_count + 1) / 2 blocks of the level above
+    inline void merge_psx_blocks(const probe_statistics_t* below,
+        size_t below_count, probe_statistics_t* level, size_t probe_count)
+    {
+        for (size_t b = 0; b < below_count; ++b) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                level[ (b / 2) * probe_count + p ].add(
+                    below[ b * probe_count + p ]);
+            }
+        }
+    }
+
+    // Build the summary pyramid of a recording by streaming its .psd files
+    // once. block_size is the number of samples per level 0 block and has to
+    // be a power of two.
+    inline psx_t build_psx(
+        const shared_psi_t& shared_psi, uint64_t block_size = 1024)
+    {
+        const psi_t& psi = *shared_psi;
+        if (block_size == 0 || (block_size & (block_size - 1)) != 0) {
+            throw std::runtime_error("Invalid psx block size of " +
+                                     std::to_string(block_size) +
+                                     " (must be a power of two)");
+        }
+        const size_t probe_count = psi.probes.size();
+
+        auto psx = pslib::v1_0::psx_t();
+        {
+            psx.checksum = psi.checksum;
+            psx.sampling_count = psi.sampling_count;
+            psx.data_count = pslib::v1_0::psd_sample_count(psi);
+            psx.probe_count = probe_count;
+            psx.revision = psi.revision;
+            psx.block_size = block_size;
+        }
+
+        // Level 0
+        const auto block_count =
+            size_t((psx.data_count + block_size - 1) / block_size);
+        psx.levels.emplace_back(block_count * probe_count);
+        const auto read = pslib::v1_0::summarize_psx_blocks(
+            shared_psi, block_size, 0, block_count, psx.levels[ 0 ].data());
+        if (read != psx.data_count) {
+            throw std::runtime_error("Expected " +
+                                     std::to_string(psx.data_count) +
+                                     " samples but only got " +
+                                     std::to_string(read) + " for " +
+                                     psi.filename);
+        }
+
+        // Each further level merges two blocks of the level below
+        while (psx.block_count(psx.levels.size() - 1) > 1) {
+            const auto& below = psx.levels.back();
+            const auto below_count = below.size() / probe_count;
+            std::vector< probe_statistics_t > level(
+                ((below_count + 1) / 2) * probe_count);
+            pslib::v1_0::merge_psx_blocks(
+                below.data(), below_count, level.data(), probe_count);
+            psx.levels.push_back(std::move(level));
+        }
+        return psx;
+    }
+}
@@ -0,0 +1,419 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pslib::v1_0 {
+    // Least and greatest number of vectors the kernels accumulate
+    // independently, at least two chains per sum overlap their latency
+    constexpr size_t column_statistics_min_vectors = 2;
+    constexpr size_t column_statistics_max_vectors = 8;
+    // Number of chunks the kernels sum up before checking for NaN values
+    constexpr size_t column_statistics_block = 1024;
+
+    // Start the shifts of the lanes with their first values, NaN values
+    // shift by 0
+    inline void init_column_shifts(
+        const double* data, size_t lane_count, double* shift)
+    {
+        for (size_t i = 0; i < lane_count; ++i) {
+            shift[ i ] = std::isnan(data[ i ]) ? 0.0 : data[ i ];
+        }
+    }
+
+    // Merge a block of a kernel, which summed up the deviations of chunks
+    // values per lane from shift, into lanes. As the shift is close to the
+    // values the sums don't cancel out. The shift of every lane moves to its
+    // mean so far.
+    inline void add_column_block(size_t lane_count, size_t chunks,
+        const double* sum, const double* sum_sq, const double* nan,
+        double* shift, statistics_t* lanes)
+    {
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto block = statistics_t();
+            block.nan_count = uint64_t(nan[ i ]);
+            block.count = chunks - block.nan_count;
+            if (block.count > 0) {
+                const auto count = double(block.count);
+                block.m1 = shift[ i ] + sum[ i ] / count;
+                block.m2 =
+                    std::max(sum_sq[ i ] - sum[ i ] * sum[ i ] / count, 0.0);
+            }
+            lanes[ i ].add(block);
+            if (lanes[ i ].count > 0) {
+                shift[ i ] = lanes[ i ].m1;
+            }
+        }
+    }
+
+    inline void store_column_extrema(size_t lane_count, const double* min,
+        const double* max, statistics_t* lanes)
+    {
+        for (size_t i = 0; i < lane_count; ++i) {
+            lanes[ i ].min = min[ i ];
+            lanes[ i ].max = max[ i ];
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // The kernels accumulate chunks of K vectors into one statistics_t per
+    // double lane. min/max return their second operand if any operand is
+    // NaN, so NaN values never replace the accumulated minimum or maximum.
+    // Every block of chunks sums up the deviations from the shift of each
+    // lane and their squares, first assuming there are no NaN values and
+    // only again with NaN values masked to 0 if a sum turned NaN, which
+    // keeps the common case free of masking. The blocks are merged into the
+    // lanes with add_column_block().
+    template < size_t K >
+    __attribute__((target("sse2"))) inline void column_statistics_sse2(
+        const double* data, size_t chunks, statistics_t* lanes)
+    {
+        constexpr size_t W = 2;
+        const auto one = _mm_set1_pd(1.0);
+        double shift[ K * W ];
+        pslib::v1_0::init_column_shifts(data, K * W, shift);
+        __m128d mins[ K ], maxs[ K ], shifts[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            mins[ j ] = _mm_set1_pd(std::numeric_limits< double >::infinity());
+            maxs[ j ] = _mm_set1_pd(-std::numeric_limits< double >::infinity());
+            shifts[ j ] = _mm_loadu_pd(shift + j * W);
+        }
+        for (size_t first = 0; first < chunks;
+             first += column_statistics_block) {
+            const auto last =
+                std::min(chunks, first + column_statistics_block);
+            __m128d sums[ K ], sums_sq[ K ], nans[ K ];
+            for (size_t j = 0; j < K; ++j) {
+                sums[ j ] = sums_sq[ j ] = nans[ j ] = _mm_setzero_pd();
+            }
+            const double* chunk = data + first * K * W;
+            for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                for (size_t j = 0; j < K; ++j) {
+                    const auto x = _mm_loadu_pd(chunk + j * W);
+                    mins[ j ] = _mm_min_pd(x, mins[ j ]);
+                    maxs[ j ] = _mm_max_pd(x, maxs[ j ]);
+                    const auto d = _mm_sub_pd(x, shifts[ j ]);
+                    sums[ j ] = _mm_add_pd(sums[ j ], d);
+                    sums_sq[ j ] = _mm_add_pd(sums_sq[ j ], _mm_mul_pd(d, d));
+                }
+            }
+            int nan_mask = 0;
+            for (size_t j = 0; j < K; ++j) {
+                nan_mask |=
+                    _mm_movemask_pd(_mm_cmpunord_pd(sums[ j ], sums[ j ]));
+            }
+            if (nan_mask != 0) {
+                for (size_t j = 0; j < K; ++j) {
+                    sums[ j ] = sums_sq[ j ] = _mm_setzero_pd();
+                }
+                chunk = data + first * K * W;
+                for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                    for (size_t j = 0; j < K; ++j) {
+                        const auto x = _mm_loadu_pd(chunk + j * W);
+                        const auto is_nan = _mm_cmpunord_pd(x, x);
+                        const auto d =
+                            _mm_andnot_pd(is_nan, _mm_sub_pd(x, shifts[ j ]));
+                        sums[ j ] = _mm_add_pd(sums[ j ], d);
+                        sums_sq[ j ] =
+                            _mm_add_pd(sums_sq[ j ], _mm_mul_pd(d, d));
+                        nans[ j ] =
+                            _mm_add_pd(nans[ j ], _mm_and_pd(is_nan, one));
+                    }
+                }
+            }
+            double out[ 3 ][ K * W ];
+            for (size_t j = 0; j < K; ++j) {
+                _mm_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+                _mm_storeu_pd(out[ 1 ] + j * W, sums_sq[ j ]);
+                _mm_storeu_pd(out[ 2 ] + j * W, nans[ j ]);
+            }
+            pslib::v1_0::add_column_block(K * W, last - first, out[ 0 ],
+                out[ 1 ], out[ 2 ], shift, lanes);
+            for (size_t j = 0; j < K; ++j) {
+                shifts[ j ] = _mm_loadu_pd(shift + j * W);
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm_storeu_pd(out[ 0 ] + j * W, mins[ j ]);
+            _mm_storeu_pd(out[ 1 ] + j * W, maxs[ j ]);
+        }
+        pslib::v1_0::store_column_extrema(K * W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    template < size_t K >
+    __attribute__((target("avx2,fma"))) inline void column_statistics_avx2(
+        const double* data, size_t chunks, statistics_t* lanes)
+    {
+        constexpr size_t W = 4;
+        const auto one = _mm256_set1_pd(1.0);
+        double shift[ K * W ];
+        pslib::v1_0::init_column_shifts(data, K * W, shift);
+        __m256d mins[ K ], maxs[ K ], shifts[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            mins[ j ] =
+                _mm256_set1_pd(std::numeric_limits< double >::infinity());
+            maxs[ j ] =
+                _mm256_set1_pd(-std::numeric_limits< double >::infinity());
+            shifts[ j ] = _mm256_loadu_pd(shift + j * W);
+        }
+        for (size_t first = 0; first < chunks;
+             first += column_statistics_block) {
+            const auto last =
+                std::min(chunks, first + column_statistics_block);
+            __m256d sums[ K ], sums_sq[ K ], nans[ K ];
+            for (size_t j = 0; j < K; ++j) {
+                sums[ j ] = sums_sq[ j ] = nans[ j ] = _mm256_setzero_pd();
+            }
+            const double* chunk = data + first * K * W;
+            for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                for (size_t j = 0; j < K; ++j) {
+                    const auto x = _mm256_loadu_pd(chunk + j * W);
+                    mins[ j ] = _mm256_min_pd(x, mins[ j ]);
+                    maxs[ j ] = _mm256_max_pd(x, maxs[ j ]);
+                    const auto d = _mm256_sub_pd(x, shifts[ j ]);
+                    sums[ j ] = _mm256_add_pd(sums[ j ], d);
+                    sums_sq[ j ] = _mm256_fmadd_pd(d, d, sums_sq[ j ]);
+                }
+            }
+            int nan_mask = 0;
+            for (size_t j = 0; j < K; ++j) {
+                nan_mask |= _mm256_movemask_pd(
+                    _mm256_cmp_pd(sums[ j ], sums[ j ], _CMP_UNORD_Q));
+            }
+            if (nan_mask != 0) {
+                for (size_t j = 0; j < K; ++j) {
+                    sums[ j ] = sums_sq[ j ] = _mm256_setzero_pd();
+                }
+                chunk = data + first * K * W;
+                for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                    for (size_t j = 0; j < K; ++j) {
+                        const auto x = _mm256_loadu_pd(chunk + j * W);
+                        const auto is_nan = _mm256_cmp_pd(x, x, _CMP_UNORD_Q);
+                        const auto d = _mm256_andnot_pd(
+                            is_nan, _mm256_sub_pd(x, shifts[ j ]));
+                        sums[ j ] = _mm256_add_pd(sums[ j ], d);
+                        sums_sq[ j ] = _mm256_fmadd_pd(d, d, sums_sq[ j ]);
+                        nans[ j ] = _mm256_add_pd(
+                            nans[ j ], _mm256_and_pd(is_nan, one));
+                    }
+                }
+            }
+            double out[ 3 ][ K * W ];
+            for (size_t j = 0; j < K; ++j) {
+                _mm256_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+                _mm256_storeu_pd(out[ 1 ] + j * W, sums_sq[ j ]);
+                _mm256_storeu_pd(out[ 2 ] + j * W, nans[ j ]);
+            }
+            pslib::v1_0::add_column_block(K * W, last - first, out[ 0 ],
+                out[ 1 ], out[ 2 ], shift, lanes);
+            for (size_t j = 0; j < K; ++j) {
+                shifts[ j ] = _mm256_loadu_pd(shift + j * W);
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm256_storeu_pd(out[ 0 ] + j * W, mins[ j ]);
+            _mm256_storeu_pd(out[ 1 ] + j * W, maxs[ j ]);
+        }
+        pslib::v1_0::store_column_extrema(K * W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    template < size_t K >
+    __attribute__((target("avx512f"))) inline void column_statistics_avx512(
+        const double* data, size_t chunks, statistics_t* lanes)
+    {
+        constexpr size_t W = 8;
+        const auto one = _mm512_set1_pd(1.0);
+        // The masked min/max avoid the undefined pass-through operand of
+        // _mm512_min_pd/_mm512_max_pd
+        const auto all = __mmask8(0xFF);
+        double shift[ K * W ];
+        pslib::v1_0::init_column_shifts(data, K * W, shift);
+        __m512d mins[ K ], maxs[ K ], shifts[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            mins[ j ] =
+                _mm512_set1_pd(std::numeric_limits< double >::infinity());
+            maxs[ j ] =
+                _mm512_set1_pd(-std::numeric_limits< double >::infinity());
+            shifts[ j ] = _mm512_loadu_pd(shift + j * W);
+        }
+        for (size_t first = 0; first < chunks;
+             first += column_statistics_block) {
+            const auto last =
+                std::min(chunks, first + column_statistics_block);
+            __m512d sums[ K ], sums_sq[ K ], nans[ K ];
+            for (size_t j = 0; j < K; ++j) {
+                sums[ j ] = sums_sq[ j ] = nans[ j ] = _mm512_setzero_pd();
+            }
+            const double* chunk = data + first * K * W;
+            for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                for (size_t j = 0; j < K; ++j) {
+                    const auto x = _mm512_loadu_pd(chunk + j * W);
+                    mins[ j ] =
+                        _mm512_mask_min_pd(mins[ j ], all, x, mins[ j ]);
+                    maxs[ j ] =
+                        _mm512_mask_max_pd(maxs[ j ], all, x, maxs[ j ]);
+                    const auto d = _mm512_sub_pd(x, shifts[ j ]);
+                    sums[ j ] = _mm512_add_pd(sums[ j ], d);
+                    sums_sq[ j ] = _mm512_fmadd_pd(d, d, sums_sq[ j ]);
+                }
+            }
+            int nan_mask = 0;
+            for (size_t j = 0; j < K; ++j) {
+                nan_mask |=
+                    _mm512_cmp_pd_mask(sums[ j ], sums[ j ], _CMP_UNORD_Q);
+            }
+            if (nan_mask != 0) {
+                for (size_t j = 0; j < K; ++j) {
+                    sums[ j ] = sums_sq[ j ] = _mm512_setzero_pd();
+                }
+                chunk = data + first * K * W;
+                for (size_t c = first; c < last; ++c, chunk += K * W) {
+#pragma GCC unroll 8
+                    for (size_t j = 0; j < K; ++j) {
+                        const auto x = _mm512_loadu_pd(chunk + j * W);
+                        const auto is_nan =
+                            _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q);
+                        const auto d = _mm512_maskz_sub_pd(
+                            __mmask8(~is_nan), x, shifts[ j ]);
+                        sums[ j ] = _mm512_add_pd(sums[ j ], d);
+                        sums_sq[ j ] = _mm512_fmadd_pd(d, d, sums_sq[ j ]);
+                        nans[ j ] = _mm512_mask_add_pd(
+                            nans[ j ], is_nan, nans[ j ], one);
+                    }
+                }
+            }
+            double out[ 3 ][ K * W ];
+            for (size_t j = 0; j < K; ++j) {
+                _mm512_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+                _mm512_storeu_pd(out[ 1 ] + j * W, sums_sq[ j ]);
+                _mm512_storeu_pd(out[ 2 ] + j * W, nans[ j ]);
+            }
+            pslib::v1_0::add_column_block(K * W, last - first, out[ 0 ],
+                out[ 1 ], out[ 2 ], shift, lanes);
+            for (size_t j = 0; j < K; ++j) {
+                shifts[ j ] = _mm512_loadu_pd(shift + j * W);
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm512_storeu_pd(out[ 0 ] + j * W, mins[ j ]);
+            _mm512_storeu_pd(out[ 1 ] + j * W, maxs[ j ]);
+        }
+        pslib::v1_0::store_column_extrema(K * W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    // Run the kernel of isa with vectors accumulators per quantity
+    inline void column_statistics_kernel(SIMD_ISA isa, size_t vectors,
+        const double* data, size_t chunks, statistics_t* lanes)
+    {
+        typedef void (*kernel_t)(const double*, size_t, statistics_t*);
+        static const kernel_t kernels[ 3 ][ 7 ] = {
+            { &column_statistics_sse2< 2 >, &column_statistics_sse2< 3 >,
+                &column_statistics_sse2< 4 >, &column_statistics_sse2< 5 >,
+                &column_statistics_sse2< 6 >, &column_statistics_sse2< 7 >,
+                &column_statistics_sse2< 8 > },
+            { &column_statistics_avx2< 2 >, &column_statistics_avx2< 3 >,
+                &column_statistics_avx2< 4 >, &column_statistics_avx2< 5 >,
+                &column_statistics_avx2< 6 >, &column_statistics_avx2< 7 >,
+                &column_statistics_avx2< 8 > },
+            { &column_statistics_avx512< 2 >, &column_statistics_avx512< 3 >,
+                &column_statistics_avx512< 4 >,
+                &column_statistics_avx512< 5 >,
+                &column_statistics_avx512< 6 >,
+                &column_statistics_avx512< 7 >,
+                &column_statistics_avx512< 8 > }
+        };
+        const size_t row = isa == SIMD_ISA::AVX512 ? 2
+                           : isa == SIMD_ISA::AVX2 ? 1
+                                                   : 0;
+        kernels[ row ][ vectors - column_statistics_min_vectors ](
+            data, chunks, lanes);
+    }
+#endif
+
+    // Add the values of a row-major table with rows rows and columns columns
+    // to stats, which holds one statistics_t per column. The vectorized
+    // kernels are used with isa (or the best instruction set of the CPU
+    // below it) as long as a whole number of rows fits into at most
+    // column_statistics_max_vectors vectors, i.e. for up to 16 columns.
+    inline void add_column_statistics(const double* data, size_t rows,
+        size_t columns, statistics_t* stats,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (columns == 0) {
+            return;
+        }
+        size_t row = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (!pslib::v1_0::simd_isa_supported(isa)) {
+            isa = pslib::v1_0::cpu_simd_isa();
+        }
+        if (isa != SIMD_ISA::SCALAR) {
+            // A chunk spans whole rows and whole vectors, so every lane of
+            // the kernel always sees values of the same column
+            const auto width = pslib::v1_0::simd_width(isa);
+            auto vectors = std::lcm(columns, width) / width;
+            vectors *= (column_statistics_min_vectors + vectors - 1) / vectors;
+            const auto chunk = vectors * width;
+            const auto chunks = rows * columns / chunk;
+            if (vectors <= column_statistics_max_vectors && chunks > 0) {
+                std::vector< statistics_t > lanes(chunk);
+                pslib::v1_0::column_statistics_kernel(
+                    isa, vectors, data, chunks, lanes.data());
+                for (size_t i = 0; i < chunk; ++i) {
+                    stats[ i % columns ].add(lanes[ i ]);
+                }
+                row = chunks * chunk / columns;
+            }
+        }
+#endif
+        for (; row < rows; ++row) {
+            for (size_t c = 0; c < columns; ++c) {
+                stats[ c ].add(data[ row * columns + c ]);
+            }
+        }
+    }
+}
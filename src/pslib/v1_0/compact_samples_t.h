@@ -0,0 +1,269 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/probe_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Mapping between a stored compact value q and its real value
+    // offset + scale * q
+    class compact_scale_t {
+        public:
+        double scale;
+        double offset;
+
+        // Scale covering [min, max] with the full int32_t range. Without a
+        // (valid) range, e.g. if all values are NaN, the values are stored
+        // unscaled.
+        static inline compact_scale_t from_range(double min, double max)
+        {
+            auto s = compact_scale_t{ 1.0, 0.0 };
+            if (std::isnan(min) || std::isnan(max) || !(min <= max)) {
+                return s;
+            }
+            s.offset = (min + max) / 2.0;
+            if (max > min) {
+                s.scale = (max - min) /
+                          (2.0 * double(std::numeric_limits< int32_t >::max()));
+            }
+            return s;
+        }
+    };
+
+    // Compact variant of samples_t which stores current and voltage as
+    // float (float_samples_t) or as int32_t scaled per probe and quantity
+    // (fixed_samples_t) instead of double. Values are only converted to
+    // double on access. Both take 4 instead of 8 bytes per value, which
+    // halves the memory needed for the values of long recordings. float
+    // keeps a precision relative to each value, int32_t a fixed resolution
+    // of 1 / 2^32 of the range of the probe.
+    //
+    // Scaled int32_t values cover the range given by current_min/max and
+    // voltage_min/max of the probe (or of the converted samples if the probe
+    // has none), values outside are clamped and NaN is stored as the
+    // smallest int32_t.
+    template < typename T >
+    class compact_samples_t {
+        static_assert(std::is_same< T, float >::value ||
+                          std::is_same< T, int32_t >::value,
+            "compact_samples_t stores float or int32_t");
+
+        public:
+        shared_psi_t psi;
+        std::chrono::nanoseconds begin_time;
+        std::chrono::nanoseconds end_time;
+        // current and voltage of every probe for every sample
+        std::vector< T > values;
+        std::vector< event_t > events;
+        // Scale of the current and voltage of every probe (unused for float)
+        std::vector< compact_scale_t > current_scales;
+        std::vector< compact_scale_t > voltage_scales;
+
+        public:
+        inline compact_samples_t(const shared_psi_t& p,
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end)
+            : psi{ p }
+            , begin_time{ begin }
+            , end_time{ end }
+        {
+            for (const auto& probe : p->probes) {
+                current_scales.push_back(compact_scale_t::from_range(
+                    probe.current_min, probe.current_max));
+                voltage_scales.push_back(compact_scale_t::from_range(
+                    probe.voltage_min, probe.voltage_max));
+            }
+        }
+
+        inline size_t size() const
+        {
+            return this->events.size() / (this->psi.probe_count() + 1);
+        }
+
+        inline double current(size_t idx, size_t probe) const
+        {
+            return decode(
+                this->values[ (idx * this->psi.probe_count() + probe) * 2 ],
+                this->current_scales[ probe ]);
+        }
+
+        inline double voltage(size_t idx, size_t probe) const
+        {
+            return decode(
+                this->values[ (idx * this->psi.probe_count() + probe) * 2 +
+                              1 ],
+                this->voltage_scales[ probe ]);
+        }
+
+        inline data_stream_t value(size_t idx, size_t probe) const
+        {
+            return data_stream_t{ this->current(idx, probe),
+                this->voltage(idx, probe) };
+        }
+
+        // Append a sample given as probe count data streams and probe count
+        // + 1 events
+        inline void push_back(const data_stream_t* record_values,
+            const event_t* record_events)
+        {
+            this->append(record_values, record_events, 1);
+        }
+
+        // Append count samples given as probe count data streams and probe
+        // count + 1 events each
+        inline void append(const data_stream_t* block_values,
+            const event_t* block_events, size_t count)
+        {
+            const size_t probe_count = this->psi.probe_count();
+            for (size_t i = 0; i < count; ++i) {
+                const auto ds = block_values + i * probe_count;
+                for (size_t p = 0; p < probe_count; ++p) {
+                    this->values.push_back(
+                        encode(ds[ p ].current, this->current_scales[ p ]));
+                    this->values.push_back(
+                        encode(ds[ p ].voltage, this->voltage_scales[ p ]));
+                }
+            }
+            this->events.insert(this->events.end(), block_events,
+                block_events + count * (probe_count + 1));
+        }
+
+        static inline T encode(double v, const compact_scale_t& s)
+        {
+            if constexpr (std::is_same< T, float >::value) {
+                return float(v);
+            }
+            else {
+                if (std::isnan(v)) {
+                    return std::numeric_limits< int32_t >::min();
+                }
+                constexpr double limit =
+                    double(std::numeric_limits< int32_t >::max());
+                return int32_t(std::llround(
+                    std::clamp((v - s.offset) / s.scale, -limit, limit)));
+            }
+        }
+
+        static inline double decode(T q, const compact_scale_t& s)
+        {
+            if constexpr (std::is_same< T, float >::value) {
+                return double(q);
+            }
+            else {
+                if (q == std::numeric_limits< int32_t >::min()) {
+                    return std::numeric_limits< double >::quiet_NaN();
+                }
+                return s.offset + s.scale * double(q);
+            }
+        }
+    };
+
+    typedef compact_samples_t< float > float_samples_t;
+    typedef compact_samples_t< int32_t > fixed_samples_t;
+
+    // Convert samples to their compact representation. Probes without a
+    // current or voltage range in the psi get the range of the samples.
+    template < typename T >
+    inline compact_samples_t< T > to_compact_samples(const samples_t& samples)
+    {
+        const size_t probe_count = samples.psi->probes.size();
+        const size_t count = samples.size();
+        auto compact = compact_samples_t< T >(
+            samples.psi, samples.begin_time, samples.end_time);
+        if (!samples.values.empty()) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                const auto& probe = samples.psi->probes[ p ];
+                auto current_min = std::numeric_limits< double >::infinity();
+                auto current_max = -current_min;
+                auto voltage_min = current_min;
+                auto voltage_max = current_max;
+                for (size_t i = 0; i < count; ++i) {
+                    const auto& ds = samples.values[ i * probe_count + p ];
+                    current_min = std::fmin(current_min, ds.current);
+                    current_max = std::fmax(current_max, ds.current);
+                    voltage_min = std::fmin(voltage_min, ds.voltage);
+                    voltage_max = std::fmax(voltage_max, ds.voltage);
+                }
+                if (std::isnan(probe.current_min) ||
+                    std::isnan(probe.current_max)) {
+                    compact.current_scales[ p ] =
+                        compact_scale_t::from_range(current_min, current_max);
+                }
+                if (std::isnan(probe.voltage_min) ||
+                    std::isnan(probe.voltage_max)) {
+                    compact.voltage_scales[ p ] =
+                        compact_scale_t::from_range(voltage_min, voltage_max);
+                }
+            }
+        }
+
+        compact.values.reserve(count * probe_count * 2);
+        compact.events.reserve(count * (probe_count + 1));
+        std::vector< data_stream_t > nans(probe_count,
+            data_stream_t{ std::numeric_limits< double >::quiet_NaN(),
+                std::numeric_limits< double >::quiet_NaN() });
+        std::vector< event_t > no_events(probe_count + 1, event_t{ 0 });
+        for (size_t i = 0; i < count; ++i) {
+            compact.push_back(samples.values.empty()
+                                  ? nans.data()
+                                  : samples.values.data() + i * probe_count,
+                samples.events.empty()
+                    ? no_events.data()
+                    : samples.events.data() + i * (probe_count + 1));
+        }
+        return compact;
+    }
+
+    // Convert compact samples back to samples_t
+    template < typename T >
+    inline samples_t to_samples(const compact_samples_t< T >& compact)
+    {
+        const size_t probe_count = compact.psi->probes.size();
+        const size_t count = compact.size();
+        auto samples =
+            samples_t(compact.psi, compact.begin_time, compact.end_time);
+        samples.values.reserve(count * probe_count);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                samples.values.push_back(compact.value(i, p));
+            }
+        }
+        samples.events.assign(compact.events.begin(), compact.events.end());
+        return samples;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cmath>
+
+namespace pslib::v1_0 {
+    // Neumaier (improved Kahan) summation. The rounding error of every
+    // addition is collected in compensation, so the error of the total does
+    // not grow with the number of values added.
+    class compensated_sum_t {
+        public:
+        double sum = 0.0;
+        double compensation = 0.0;
+
+        public:
+        inline void add(double v)
+        {
+            const auto t = this->sum + v;
+            if (std::fabs(this->sum) >= std::fabs(v)) {
+                this->compensation += (this->sum - t) + v;
+            }
+            else {
+                this->compensation += (v - t) + this->sum;
+            }
+            this->sum = t;
+        }
+
+        inline void add(const compensated_sum_t& s)
+        {
+            this->add(s.sum);
+            this->compensation += s.compensation;
+        }
+
+        inline double value() const
+        {
+            return this->sum + this->compensation;
+        }
+    };
+}
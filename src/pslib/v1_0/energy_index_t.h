@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/compensated_sum_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Power sum (in W, i.e. energy in multiples of the sampling interval) and
+    // number of samples with NaN power of a probe from the beginning of the
+    // recording up to a block boundary. Samples with NaN power count as 0 W.
+    class cumulative_energy_t {
+        public:
+        compensated_sum_t power_sum;
+        uint64_t nan_count = 0;
+
+        public:
+        inline void add(const cumulative_energy_t& e)
+        {
+            this->power_sum.add(e.power_sum);
+            this->nan_count += e.nan_count;
+        }
+    };
+
+    // Cumulative energy of every probe at every block boundary of a
+    // recording as stored in the .pei sidecar file of a .psi file. The
+    // energy of any range of whole blocks is the difference of two entries.
+    class energy_index_t {
+        public:
+        // Values of the psi this index was built from, used to detect a
+        // stale index
+        uint32_t checksum;
+        uint64_t sampling_count;
+        uint64_t data_count;
+        uint64_t probe_count;
+        uint64_t revision;
+
+        // Number of samples per block
+        uint64_t block_size;
+        // cumulative[ b * probe_count + p ] holds probe p over the samples
+        // before position(b), for b in [0, block_count()]
+        std::vector< cumulative_energy_t > cumulative;
+
+        public:
+        inline size_t block_count() const
+        {
+            return this->cumulative.size() / size_t(this->probe_count) - 1;
+        }
+
+        // Index of the first sample of block b (or data_count for the end of
+        // the last block)
+        inline size_t position(size_t block) const
+        {
+            return size_t(
+                std::min(block * this->block_size, this->data_count));
+        }
+
+        inline const cumulative_energy_t& at(size_t block, size_t probe) const
+        {
+            return this->cumulative[ block * this->probe_count + probe ];
+        }
+    };
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/compensated_sum_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstdint>
+
+namespace pslib::v1_0 {
+    // Rule used to integrate the power over time
+    enum class INTEGRATION {
+        // Every sample holds its power for one sampling interval
+        RECTANGLE,
+        // The power changes linearly between two samples
+        TRAPEZOID
+    };
+
+    // Running energy of a probe over consecutive samples. Current is taken
+    // in A and voltage in V, so power is in W and energy in J.
+    class probe_energy_t {
+        public:
+        // Sampling interval in seconds, kept exact (not truncated to whole
+        // nano seconds) as it scales every energy
+        std::chrono::duration< double > interval =
+            std::chrono::duration< double >(0.0);
+        // Number of samples added, including those with NaN power
+        uint64_t count = 0;
+        uint64_t nan_count = 0;
+        double first_power = 0.0;
+        double last_power = 0.0;
+        compensated_sum_t power_sum;
+
+        public:
+        // Add the energy of the samples directly following the ones added
+        // so far
+        inline void add(const probe_energy_t& e)
+        {
+            if (e.count == 0) {
+                return;
+            }
+            if (this->count == 0) {
+                this->interval = e.interval;
+                this->first_power = e.first_power;
+            }
+            this->count += e.count;
+            this->nan_count += e.nan_count;
+            this->last_power = e.last_power;
+            this->power_sum.add(e.power_sum);
+        }
+
+        // Return the time the samples span with rule (rounded to whole nano
+        // seconds)
+        inline std::chrono::nanoseconds duration(
+            INTEGRATION rule = INTEGRATION::TRAPEZOID) const
+        {
+            return std::chrono::round< std::chrono::nanoseconds >(
+                this->seconds(rule));
+        }
+
+        // Return the energy in J
+        inline double energy(INTEGRATION rule = INTEGRATION::TRAPEZOID) const
+        {
+            if (this->count == 0) {
+                return 0.0;
+            }
+            auto sum = this->power_sum.value();
+            if (rule == INTEGRATION::TRAPEZOID) {
+                sum -= (this->first_power + this->last_power) / 2.0;
+            }
+            return sum * this->interval.count();
+        }
+
+        // Return the average power in W
+        inline double average_power(
+            INTEGRATION rule = INTEGRATION::TRAPEZOID) const
+        {
+            if (rule == INTEGRATION::TRAPEZOID && this->count == 1) {
+                return this->first_power;
+            }
+            return this->energy(rule) / this->seconds(rule).count();
+        }
+
+        private:
+        inline std::chrono::duration< double > seconds(
+            INTEGRATION rule) const
+        {
+            if (this->count == 0) {
+                return std::chrono::duration< double >(0.0);
+            }
+            const auto steps = rule == INTEGRATION::TRAPEZOID
+                                   ? this->count - 1
+                                   : this->count;
+            return double(steps) * this->interval;
+        }
+    };
+}
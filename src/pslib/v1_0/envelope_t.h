@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Summary of the values of one probe within one envelope bucket
+    class envelope_value_t {
+        public:
+        double current_min;
+        double current_max;
+        double current_mean;
+        double voltage_min;
+        double voltage_max;
+        double voltage_mean;
+    };
+
+    class envelope_bucket_t {
+        public:
+        // Time of the first sample in this bucket
+        std::chrono::nanoseconds time;
+        size_t sample_count;
+        // True if any event (of any probe or the global event) occured
+        bool event;
+    };
+
+    // A decimated view of a time range, e.g. for plotting, where each bucket
+    // summarises bucket_size consecutive samples
+    class envelope_t {
+        public:
+        // Shared with all other samples of the same recording, use psi-> to
+        // access the psi_t
+        shared_psi_t psi;
+        std::chrono::nanoseconds begin_time;
+        std::chrono::nanoseconds end_time;
+        // Number of samples per bucket (the last bucket may hold less)
+        size_t bucket_size;
+        std::vector< envelope_bucket_t > buckets;
+        // One envelope_value_t per probe for each bucket
+        std::vector< envelope_value_t > values;
+
+        public:
+        inline envelope_t(const shared_psi_t& p,
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end,
+            size_t bucket)
+            : psi{ p }
+            , begin_time{ begin }
+            , end_time{ end }
+            , bucket_size{ bucket }
+        {
+        }
+
+        inline size_t size() const
+        {
+            return this->buckets.size();
+        }
+
+        inline const envelope_value_t& value(
+            size_t bucket_idx, size_t probe_idx) const
+        {
+            return this->values[ bucket_idx * this->psi.probe_count() +
+                                 probe_idx ];
+        }
+    };
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cstdint>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // A single occured event
+    class event_occurrence_t {
+        public:
+        // Index of the sample within the recording
+        uint64_t sample;
+        // Index of the probe the event belongs to, the global event uses the
+        // slot psi.probes.size()
+        uint16_t slot;
+        // Event code (event_t::value())
+        uint16_t value;
+        // Explicit padding which is always 0, so no uninitialized bytes end
+        // up in the .pev file
+        uint32_t reserved;
+    };
+    static_assert(sizeof(event_occurrence_t) == 16,
+        "event_occurrence_t is stored as is in .pev files");
+
+    inline bool operator==(
+        const event_occurrence_t& lhs, const event_occurrence_t& rhs)
+    {
+        return lhs.sample == rhs.sample && lhs.slot == rhs.slot &&
+               lhs.value == rhs.value;
+    }
+
+    inline bool operator!=(
+        const event_occurrence_t& lhs, const event_occurrence_t& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // Index of all occured events of a recording as stored in the .pev
+    // sidecar file of a .psi file
+    class event_index_t {
+        public:
+        // Values of the psi this index was built from, used to detect a
+        // stale index
+        uint32_t checksum;
+        uint64_t sampling_count;
+        uint64_t data_count;
+        uint64_t probe_count;
+        uint64_t revision;
+
+        // All occurences ordered by sample and slot
+        std::vector< event_occurrence_t > occurrences;
+    };
+}
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/event_index_t.h"
+#include "pslib/v1_0/load_event_index.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Return all events of index which occured in [begin, end] (same as
+    // load_samples). A value or slot of -1 matches any event code or slot.
+    // Throws if index wasn't built from the recording described by psi.
+    inline std::vector< event_occurrence_t > find_events(
+        const event_index_t& index, const psi_t& psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        int32_t value = -1, int32_t slot = -1)
+    {
+        if (pslib::v1_0::event_index_is_stale(index, psi)) {
+            throw std::runtime_error("Stale PEV for " + psi.filename);
+        }
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const auto range_end = uint64_t(range.first + range.count);
+
+        std::vector< event_occurrence_t > found;
+        auto it = std::lower_bound(index.occurrences.begin(),
+            index.occurrences.end(), uint64_t(range.first),
+            [](const event_occurrence_t& o, uint64_t sample) {
+                return o.sample < sample;
+            });
+        for (; it != index.occurrences.end() && it->sample < range_end; ++it) {
+            if ((value < 0 || it->value == value) &&
+                (slot < 0 || it->slot == slot)) {
+                found.push_back(*it);
+            }
+        }
+        return found;
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cstddef>
+#include <iterator>
+
+namespace pslib::v1_0 {
+    // Random access iterator over the elements of a container which yields
+    // (*container)[idx] by value, e.g. a view on a sample. Its reference is
+    // the value itself (a proxy, as in C++20 iterators) rather than a
+    // Value&, which the standard algorithms including the parallel ones
+    // (std::execution::par_unseq) accept as test.sample_view checks.
+    // Container has to provide Value operator[](size_t) const.
+    template < typename Container, typename Value >
+    class indexed_iterator {
+        private:
+        size_t m_idx;
+        const Container* m_container;
+
+        public:
+        // operator-> has to return something with an operator->
+        class arrow_proxy {
+            private:
+            Value m_value;
+
+            public:
+            inline arrow_proxy(const Value& value)
+                : m_value{ value }
+            {
+            }
+            inline const Value* operator->() const
+            {
+                return &m_value;
+            }
+        };
+
+        typedef indexed_iterator self_type;
+        typedef Value value_type;
+        typedef Value reference;
+        typedef arrow_proxy pointer;
+        typedef ptrdiff_t difference_type;
+        typedef std::random_access_iterator_tag iterator_category;
+
+        public:
+        inline indexed_iterator()
+            : m_idx{ 0 }
+            , m_container{ nullptr }
+        {
+        }
+        inline indexed_iterator(size_t idx, const Container* container)
+            : m_idx{ idx }
+            , m_container{ container }
+        {
+        }
+
+        inline self_type& operator++()
+        {
+            m_idx++;
+            return *this;
+        }
+        inline self_type operator++(int junk)
+        {
+            self_type i = *this;
+            m_idx++;
+            return i;
+        }
+        inline self_type& operator--()
+        {
+            m_idx--;
+            return *this;
+        }
+        inline self_type operator--(int junk)
+        {
+            self_type i = *this;
+            m_idx--;
+            return i;
+        }
+        inline self_type& operator+=(difference_type n)
+        {
+            m_idx = size_t(difference_type(m_idx) + n);
+            return *this;
+        }
+        inline self_type& operator-=(difference_type n)
+        {
+            m_idx = size_t(difference_type(m_idx) - n);
+            return *this;
+        }
+        inline self_type operator+(difference_type n) const
+        {
+            return self_type(size_t(difference_type(m_idx) + n), m_container);
+        }
+        inline friend self_type operator+(
+            difference_type n, const self_type& it)
+        {
+            return it + n;
+        }
+        inline self_type operator-(difference_type n) const
+        {
+            return self_type(size_t(difference_type(m_idx) - n), m_container);
+        }
+        inline difference_type operator-(const self_type& rhs) const
+        {
+            return difference_type(m_idx) - difference_type(rhs.m_idx);
+        }
+        inline reference operator*() const
+        {
+            return (*m_container)[ m_idx ];
+        }
+        inline pointer operator->() const
+        {
+            return arrow_proxy((*m_container)[ m_idx ]);
+        }
+        inline reference operator[](difference_type n) const
+        {
+            return (*m_container)[ size_t(difference_type(m_idx) + n) ];
+        }
+        inline bool operator==(const self_type& rhs) const
+        {
+            return m_idx == rhs.m_idx && m_container == rhs.m_container;
+        }
+        inline bool operator!=(const self_type& rhs) const
+        {
+            return !(*this == rhs);
+        }
+        inline bool operator<(const self_type& rhs) const
+        {
+            return m_idx < rhs.m_idx;
+        }
+        inline bool operator>(const self_type& rhs) const
+        {
+            return m_idx > rhs.m_idx;
+        }
+        inline bool operator<=(const self_type& rhs) const
+        {
+            return m_idx <= rhs.m_idx;
+        }
+        inline bool operator>=(const self_type& rhs) const
+        {
+            return m_idx >= rhs.m_idx;
+        }
+    };
+}
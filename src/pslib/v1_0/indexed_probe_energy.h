@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/energy_index_t.h"
+#include "pslib/v1_0/energy_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/load_energy_index.h"
+#include "pslib/v1_0/probe_energy.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Return the energy of each probe over the samples in [begin, end] (same
+    // as load_samples) like probe_energy with NAN_POLICY::SKIP. Whole blocks
+    // are taken from the index as the difference of two entries, only the
+    // samples of the partial blocks at both edges are read from the .psd
+    // files.
+    inline std::vector< probe_energy_t > indexed_probe_energy(
+        const energy_index_t& index, const shared_psi_t& psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (pslib::v1_0::energy_index_is_stale(index, *psi)) {
+            throw std::runtime_error(
+                "Stale energy index for " + psi->filename);
+        }
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi->length();
+        }
+        const size_t probe_count = psi.probe_count();
+
+        const auto range = pslib::v1_0::sample_range(*psi, begin, end);
+        const auto range_end = range.first + range.count;
+        const auto block_size = size_t(index.block_size);
+
+        // The samples of [first, last) are read with positional reads which
+        // share one buffer, instead of a sample_reader per edge
+        std::vector< char > buffer;
+        std::vector< data_stream_t > values;
+        std::vector< event_t > events;
+        auto edge = [&](size_t first, size_t last) {
+            std::vector< probe_energy_t > energies(probe_count);
+            if (first >= last) {
+                return energies;
+            }
+            pslib::v1_0::for_each_psd_segment(*psi,
+                sample_range_t{ first, last - first },
+                [&](const psd_t& psd, size_t psd_first, size_t count) {
+                    return pslib::v1_0::read_psd_records(*psi, psd, psd_first,
+                        count, buffer, [&](const char* records, size_t n) {
+                            values.resize(n * probe_count);
+                            events.resize(n * (probe_count + 1));
+                            pslib::v1_0::decode_samples(records, n,
+                                probe_count, values.data(), events.data());
+                            pslib::v1_0::add_probe_energy(values.data(), n,
+                                psi.exact_interval(), energies,
+                                NAN_POLICY::SKIP, isa);
+                        });
+                });
+            return energies;
+        };
+
+        // Whole blocks within the range, the last (partial) block of the
+        // recording counts as whole if the range reaches its end
+        const auto block_first = (range.first + block_size - 1) / block_size;
+        auto block_last = range_end / block_size;
+        if (range.count > 0 && range_end == index.data_count) {
+            block_last = index.block_count();
+        }
+        if (block_first >= block_last) {
+            return edge(range.first, range_end);
+        }
+        const auto middle_first = index.position(block_first);
+        const auto middle_end = index.position(block_last);
+
+        auto energies = edge(range.first, middle_first);
+        const auto right = edge(middle_end, range_end);
+        // The power of the samples at both ends of the blocks is only needed
+        // if no edge samples come before or after them
+        const auto first_sample =
+            energies[ 0 ].count == 0
+                ? edge(middle_first, middle_first + 1)
+                : std::vector< probe_energy_t >(probe_count);
+        const auto last_sample =
+            right[ 0 ].count == 0 ? edge(middle_end - 1, middle_end)
+                                  : std::vector< probe_energy_t >(probe_count);
+
+        for (size_t p = 0; p < probe_count; ++p) {
+            const auto& lo = index.at(block_first, p);
+            const auto& hi = index.at(block_last, p);
+            auto middle = pslib::v1_0::probe_energy_t();
+            middle.interval = psi.exact_interval();
+            middle.count = middle_end - middle_first;
+            middle.nan_count = hi.nan_count - lo.nan_count;
+            middle.first_power = first_sample[ p ].first_power;
+            middle.last_power = last_sample[ p ].last_power;
+            middle.power_sum = hi.power_sum;
+            middle.power_sum.add(
+                compensated_sum_t{ -lo.power_sum.sum,
+                    -lo.power_sum.compensation });
+            energies[ p ].add(middle);
+            energies[ p ].add(right[ p ]);
+        }
+        return energies;
+    }
+}
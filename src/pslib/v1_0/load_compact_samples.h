@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/compact_samples_t.h"
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Same as load_samples but the samples are converted to their compact
+    // representation block by block while reading, so the full precision
+    // samples are never held in memory at once. The int32_t scales are
+    // taken from the probe ranges of psi. Probes without a range get the
+    // range of the loaded samples, which takes an additional pass over the
+    // .psd files.
+    template < typename T >
+    inline compact_samples_t< T > load_compact_samples(
+        const shared_psi_t& shared_psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1))
+    {
+        const psi_t& psi = *shared_psi;
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        auto samples =
+            pslib::v1_0::compact_samples_t< T >(shared_psi, begin, end);
+
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const size_t probe_count = psi.probes.size();
+
+        // Pass all records of the range to decode(records, n)
+        std::vector< char > buffer;
+        auto read_range = [&](auto&& decode) {
+            pslib::v1_0::for_each_psd_segment(psi, range,
+                [&](const psd_t& psd, size_t first, size_t count) {
+                    return pslib::v1_0::read_psd_records(
+                        psi, psd, first, count, buffer, decode);
+                });
+        };
+
+        // Decode a block of n records at once into values and events
+        std::vector< data_stream_t > values;
+        std::vector< event_t > events;
+        auto decode_block = [&](const char* records, size_t n) {
+            values.resize(n * probe_count);
+            events.resize(n * (probe_count + 1));
+            pslib::v1_0::decode_samples(
+                records, n, probe_count, values.data(), events.data());
+        };
+
+        if constexpr (std::is_same< T, int32_t >::value) {
+            bool unscaled = false;
+            for (const auto& probe : psi.probes) {
+                unscaled = unscaled || std::isnan(probe.current_min) ||
+                           std::isnan(probe.current_max) ||
+                           std::isnan(probe.voltage_min) ||
+                           std::isnan(probe.voltage_max);
+            }
+            if (unscaled) {
+                const auto inf = std::numeric_limits< double >::infinity();
+                std::vector< data_stream_t > min(
+                    probe_count, data_stream_t{ inf, inf });
+                std::vector< data_stream_t > max(
+                    probe_count, data_stream_t{ -inf, -inf });
+                read_range([&](const char* records, size_t n) {
+                    decode_block(records, n);
+                    for (size_t i = 0; i < n; ++i) {
+                        for (size_t p = 0; p < probe_count; ++p) {
+                            const auto& ds = values[ i * probe_count + p ];
+                            min[ p ].current =
+                                std::fmin(min[ p ].current, ds.current);
+                            max[ p ].current =
+                                std::fmax(max[ p ].current, ds.current);
+                            min[ p ].voltage =
+                                std::fmin(min[ p ].voltage, ds.voltage);
+                            max[ p ].voltage =
+                                std::fmax(max[ p ].voltage, ds.voltage);
+                        }
+                    }
+                });
+                for (size_t p = 0; p < probe_count; ++p) {
+                    const auto& probe = psi.probes[ p ];
+                    if (std::isnan(probe.current_min) ||
+                        std::isnan(probe.current_max)) {
+                        samples.current_scales[ p ] =
+                            compact_scale_t::from_range(
+                                min[ p ].current, max[ p ].current);
+                    }
+                    if (std::isnan(probe.voltage_min) ||
+                        std::isnan(probe.voltage_max)) {
+                        samples.voltage_scales[ p ] =
+                            compact_scale_t::from_range(
+                                min[ p ].voltage, max[ p ].voltage);
+                    }
+                }
+            }
+        }
+
+        samples.values.reserve(range.count * probe_count * 2);
+        samples.events.reserve(range.count * (probe_count + 1));
+        read_range([&](const char* records, size_t n) {
+            decode_block(records, n);
+            samples.append(values.data(), events.data(), n);
+        });
+        return samples;
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/build_energy_index.h"
+#include "pslib/v1_0/energy_index_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/save_energy_index.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    inline pslib::v1_0::energy_index_t load_energy_index(
+        const std::string& filename)
+    {
+        std::ifstream pei_file(filename, std::ios::binary | std::ios::ate);
+        if (!pei_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+        const auto file_size = uint64_t(pei_file.tellg());
+        pei_file.seekg(0);
+
+        auto read = [&](auto& value) {
+            pei_file.read(reinterpret_cast< char* >(&value), sizeof(value));
+        };
+        char magic[ sizeof(pei_magic) ];
+        pei_file.read(magic, sizeof(magic));
+        if (!pei_file.good() ||
+            std::memcmp(magic, pei_magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Invalid PEI file " + filename);
+        }
+
+        auto index = pslib::v1_0::energy_index_t();
+        uint64_t size = 0;
+        read(index.checksum);
+        read(index.sampling_count);
+        read(index.data_count);
+        read(index.probe_count);
+        read(index.block_size);
+        read(index.revision);
+        read(size);
+        if (!pei_file.good() || index.probe_count == 0 ||
+            index.block_size == 0) {
+            throw std::runtime_error("Invalid PEI file " + filename);
+        }
+        // One entry per probe at every block boundary, checked against the
+        // file size before anything is allocated for them
+        const auto boundaries =
+            index.data_count / index.block_size +
+            (index.data_count % index.block_size != 0 ? 1 : 0) + 1;
+        const auto header_size = uint64_t(pei_file.tellg());
+        if (boundaries > file_size / sizeof(cumulative_energy_t) /
+                             index.probe_count ||
+            size != boundaries * index.probe_count ||
+            header_size + size * sizeof(cumulative_energy_t) != file_size) {
+            throw std::runtime_error("Invalid PEI file " + filename);
+        }
+        index.cumulative.resize(size_t(size));
+        pei_file.read(reinterpret_cast< char* >(index.cumulative.data()),
+            std::streamsize(sizeof(cumulative_energy_t) * size));
+        if (!pei_file.good()) {
+            throw std::runtime_error("Truncated PEI file " + filename);
+        }
+        return index;
+    }
+
+    // Return true if index wasn't built from the recording described by psi
+    inline bool energy_index_is_stale(
+        const energy_index_t& index, const psi_t& psi)
+    {
+        return index.checksum != psi.checksum ||
+               index.sampling_count != psi.sampling_count ||
+               index.data_count != pslib::v1_0::psd_sample_count(psi) ||
+               index.probe_count != psi.probes.size() ||
+               index.revision != psi.revision;
+    }
+
+    // Load the .pei file next to the .psi file of psi. If it doesn't exist,
+    // can't be read, is stale or has another block size it is rebuilt from
+    // the .psd files and saved.
+    inline pslib::v1_0::energy_index_t open_energy_index(
+        const shared_psi_t& psi, uint64_t block_size = energy_index_block_size,
+        size_t thread_count = 0)
+    {
+        auto filename = pslib::v1_0::psi_sidecar_filename(*psi, ".pei");
+        if (boost::filesystem::exists(filename)) {
+            try {
+                auto index = load_energy_index(filename);
+                if (!energy_index_is_stale(index, *psi) &&
+                    index.block_size == block_size) {
+                    return index;
+                }
+            }
+            catch (std::runtime_error&) {
+                // Rebuild broken index files below
+            }
+        }
+
+        auto index =
+            pslib::v1_0::build_energy_index(psi, block_size, thread_count);
+        auto path = boost::filesystem::path(filename);
+        auto directory = path.parent_path().string();
+        pslib::v1_0::save_energy_index(
+            index, directory.empty() ? "." : directory, path.stem().string());
+        return index;
+    }
+}
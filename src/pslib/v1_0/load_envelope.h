@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/envelope_t.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Load a decimated envelope of (at most) point_count buckets of the
+    // samples in [begin, end] (same as load_samples). The .psd files are
+    // streamed once with a sample_reader, so the full-rate samples are never
+    // held in memory. NaN values enter min, max and mean of a bucket
+    // according to policy (see probe_statistics).
+    inline envelope_t load_envelope(const shared_psi_t& shared_psi,
+        size_t point_count,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        NAN_POLICY policy = NAN_POLICY::SKIP)
+    {
+        const psi_t& psi = *shared_psi;
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const size_t probe_count = psi.probes.size();
+        point_count = std::max(point_count, size_t(1));
+
+        auto envelope = pslib::v1_0::envelope_t(shared_psi, begin, end,
+            std::max((range.count + point_count - 1) / point_count, size_t(1)));
+
+        const size_t bucket_count =
+            (range.count + envelope.bucket_size - 1) / envelope.bucket_size;
+        envelope.buckets.reserve(bucket_count);
+        // Statistics of each probe in each bucket
+        std::vector< probe_statistics_t > stats(bucket_count * probe_count);
+
+        auto reader = pslib::v1_0::sample_reader(shared_psi, begin, end);
+        while (auto block = reader.next()) {
+            for (size_t i = 0; i < block->size(); ++i) {
+                const auto idx = block->first + i - range.first;
+                const auto bucket_idx = idx / envelope.bucket_size;
+                if (bucket_idx == envelope.buckets.size()) {
+                    envelope.buckets.push_back(pslib::v1_0::envelope_bucket_t{
+                        (block->first + i) * psi.sampling_interval(), 0,
+                        false });
+                }
+                auto& bucket = envelope.buckets[ bucket_idx ];
+                bucket.sample_count++;
+
+                const auto values = block->values.data() + i * probe_count;
+                auto summary = stats.data() + bucket_idx * probe_count;
+                for (size_t p = 0; p < probe_count; ++p) {
+                    summary[ p ].add(values[ p ]);
+                }
+
+                const auto events =
+                    block->events.data() + i * (probe_count + 1);
+                for (size_t e = 0; e < probe_count + 1; ++e) {
+                    auto event = events[ e ];
+                    bucket.event = bucket.event || event.occured();
+                }
+            }
+        }
+
+        // Reduce the statistics to the envelope values and drop buckets
+        // never reached because of a truncated psd file
+        envelope.values.resize(envelope.buckets.size() * probe_count);
+        for (size_t k = 0; k < envelope.values.size(); ++k) {
+            auto& s = stats[ k ];
+            s.apply(policy);
+            envelope.values[ k ] = pslib::v1_0::envelope_value_t{
+                s.current.min, s.current.max, s.current.mean(),
+                s.voltage.min, s.voltage.max, s.voltage.mean() };
+        }
+        return envelope;
+    }
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/build_event_index.h"
+#include "pslib/v1_0/event_index_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/save_event_index.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    inline pslib::v1_0::event_index_t load_event_index(
+        const std::string& filename)
+    {
+        std::ifstream pev_file(filename, std::ios::binary | std::ios::ate);
+        if (!pev_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+        const auto file_size = uint64_t(pev_file.tellg());
+        pev_file.seekg(0);
+
+        auto read = [&](auto& value) {
+            pev_file.read(reinterpret_cast< char* >(&value), sizeof(value));
+        };
+        char magic[ sizeof(pev_magic) ];
+        pev_file.read(magic, sizeof(magic));
+        if (!pev_file.good() ||
+            std::memcmp(magic, pev_magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Invalid PEV file " + filename);
+        }
+
+        auto index = pslib::v1_0::event_index_t();
+        uint64_t count = 0;
+        read(index.checksum);
+        read(index.sampling_count);
+        read(index.data_count);
+        read(index.probe_count);
+        read(index.revision);
+        read(count);
+        // The occurrences have to fill the rest of the file exactly, which
+        // is checked before anything is allocated for them
+        const auto header_size = uint64_t(pev_file.tellg());
+        if (!pev_file.good() ||
+            count > file_size / sizeof(event_occurrence_t) ||
+            header_size + count * sizeof(event_occurrence_t) != file_size) {
+            throw std::runtime_error("Invalid PEV file " + filename);
+        }
+        index.occurrences.resize(count);
+        pev_file.read(reinterpret_cast< char* >(index.occurrences.data()),
+            std::streamsize(sizeof(event_occurrence_t) * count));
+        if (!pev_file.good()) {
+            throw std::runtime_error("Truncated PEV file " + filename);
+        }
+        return index;
+    }
+
+    // Return true if index wasn't built from the recording described by psi
+    inline bool event_index_is_stale(
+        const event_index_t& index, const psi_t& psi)
+    {
+        return index.checksum != psi.checksum ||
+               index.sampling_count != psi.sampling_count ||
+               index.data_count != pslib::v1_0::psd_sample_count(psi) ||
+               index.probe_count != psi.probes.size() ||
+               index.revision != psi.revision;
+    }
+
+    // Load the .pev file next to the .psi file of psi. If it doesn't exist,
+    // can't be read or is stale it is rebuilt from the .psd files and saved.
+    inline pslib::v1_0::event_index_t open_event_index(
+        const shared_psi_t& shared_psi)
+    {
+        const psi_t& psi = *shared_psi;
+        auto filename = pslib::v1_0::psi_sidecar_filename(psi, ".pev");
+        if (boost::filesystem::exists(filename)) {
+            try {
+                auto index = load_event_index(filename);
+                if (!event_index_is_stale(index, psi)) {
+                    return index;
+                }
+            }
+            catch (std::runtime_error&) {
+                // Rebuild broken pev files below
+            }
+        }
+
+        auto index = pslib::v1_0::build_event_index(shared_psi);
+        auto path = boost::filesystem::path(filename);
+        auto directory = path.parent_path().string();
+        pslib::v1_0::save_event_index(
+            index, directory.empty() ? "." : directory, path.stem().string());
+        return index;
+    }
+}
@@ -66,6 +66,10 @@ namespace pslib::v1_0 {
                 "Invalid Checksum Value " + psi_checksum + " in " + filename);
         }
 
+        // Get Revision (only written for modified recordings)
+        psi.revision =
+            psi_xml.get< uint64_t >("PSI.Revision.<xmlattr>.Value", 0);
+
         // Get SamplingRate (and transform it from kHz to Hz)
         psi.sampling_rate =
             psi_xml.get< uint64_t >(
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/build_psx.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/psx_t.h"
+#include "pslib/v1_0/save_psx.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Read the header of the .psx file filename of file_size bytes up to
+    // its levels. Returns the psx without its levels, sizes receives the
+    // number of statistics of every level as build_psx produces them, which
+    // are checked against the file size before anything is allocated for
+    // them.
+    inline pslib::v1_0::psx_t read_psx_header(std::istream& psx_file,
+        uint64_t file_size, const std::string& filename,
+        std::vector< uint64_t >& sizes)
+    {
+        auto read = [&](auto& value) {
+            psx_file.read(reinterpret_cast< char* >(&value), sizeof(value));
+        };
+        char magic[ sizeof(psx_magic) ];
+        psx_file.read(magic, sizeof(magic));
+        if (!psx_file.good() ||
+            std::memcmp(magic, psx_magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Invalid PSX file " + filename);
+        }
+
+        auto psx = pslib::v1_0::psx_t();
+        uint64_t level_count = 0;
+        read(psx.checksum);
+        read(psx.sampling_count);
+        read(psx.data_count);
+        read(psx.probe_count);
+        read(psx.block_size);
+        read(psx.revision);
+        read(level_count);
+        if (!psx_file.good() || psx.probe_count == 0 || psx.block_size == 0 ||
+            (psx.block_size & (psx.block_size - 1)) != 0) {
+            throw std::runtime_error("Invalid PSX file " + filename);
+        }
+
+        sizes.clear();
+        auto expected_size = uint64_t(psx_file.tellg());
+        auto blocks = psx.data_count / psx.block_size +
+                      (psx.data_count % psx.block_size != 0 ? 1 : 0);
+        while (true) {
+            if (blocks > file_size / sizeof(probe_statistics_t) /
+                             psx.probe_count) {
+                throw std::runtime_error("Invalid PSX file " + filename);
+            }
+            sizes.push_back(blocks * psx.probe_count);
+            expected_size +=
+                sizeof(uint64_t) + sizes.back() * sizeof(probe_statistics_t);
+            if (blocks <= 1) {
+                break;
+            }
+            blocks = (blocks + 1) / 2;
+        }
+        if (level_count != sizes.size() || expected_size != file_size) {
+            throw std::runtime_error("Invalid PSX file " + filename);
+        }
+        return psx;
+    }
+
+    inline pslib::v1_0::psx_t load_psx(const std::string& filename)
+    {
+        std::ifstream psx_file(filename, std::ios::binary | std::ios::ate);
+        if (!psx_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+        const auto file_size = uint64_t(psx_file.tellg());
+        psx_file.seekg(0);
+
+        std::vector< uint64_t > sizes;
+        auto psx = read_psx_header(psx_file, file_size, filename, sizes);
+        for (size_t l = 0; l < sizes.size(); ++l) {
+            uint64_t size = 0;
+            psx_file.read(reinterpret_cast< char* >(&size), sizeof(size));
+            if (!psx_file.good() || size != sizes[ l ]) {
+                throw std::runtime_error("Invalid PSX level " +
+                                         std::to_string(l) + " in " + filename);
+            }
+            psx.levels.emplace_back(size);
+            psx_file.read(reinterpret_cast< char* >(psx.levels.back().data()),
+                std::streamsize(sizeof(probe_statistics_t) * size));
+        }
+        if (!psx_file.good()) {
+            throw std::runtime_error("Truncated PSX file " + filename);
+        }
+        return psx;
+    }
+
+    // Return true if psx wasn't built from the recording described by psi
+    inline bool psx_is_stale(const psx_t& psx, const psi_t& psi)
+    {
+        return psx.checksum != psi.checksum ||
+               psx.sampling_count != psi.sampling_count ||
+               psx.data_count != pslib::v1_0::psd_sample_count(psi) ||
+               psx.probe_count != psi.probes.size() ||
+               psx.revision != psi.revision;
+    }
+
+    // Load the .psx file next to the .psi file of psi. If it doesn't exist,
+    // can't be read, is stale or has another block size it is rebuilt from
+    // the .psd files and saved.
+    inline pslib::v1_0::psx_t open_psx(
+        const shared_psi_t& shared_psi, uint64_t block_size = 1024)
+    {
+        const psi_t& psi = *shared_psi;
+        auto filename = pslib::v1_0::psi_sidecar_filename(psi, ".psx");
+        if (boost::filesystem::exists(filename)) {
+            try {
+                auto psx = load_psx(filename);
+                if (!psx_is_stale(psx, psi) && psx.block_size == block_size) {
+                    return psx;
+                }
+            }
+            catch (std::runtime_error&) {
+                // Rebuild broken psx files below
+            }
+        }
+
+        auto psx = pslib::v1_0::build_psx(shared_psi, block_size);
+        auto path = boost::filesystem::path(filename);
+        auto directory = path.parent_path().string();
+        pslib::v1_0::save_psx(
+            psx, directory.empty() ? "." : directory, path.stem().string());
+        return psx;
+    }
+}
@@ -23,63 +23,170 @@
 #pragma once
 
 // Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/projection_t.h"
 #include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
 #include "pslib/v1_0/psd_t.h"
 #include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/read_psd.h"
 #include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
 
 // StdLib
+#include <algorithm>
 #include <chrono>
-#include <fstream>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace pslib::v1_0 {
+    // Load the samples with a time in [begin, end]. Their storage is
+    // allocated from resource. Loading stops at the first gap in the psds
+    // or truncated .psd file, a missing .psd file throws (see
+    // read_psd_records).
+    inline samples_t load_samples(const shared_psi_t& shared_psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        std::pmr::memory_resource* resource =
+            std::pmr::get_default_resource())
+    {
+        const psi_t& psi = *shared_psi;
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        auto samples = pslib::v1_0::samples_t(shared_psi, begin, end, resource);
+
+        // Jump directly to the first psd and record of the requested range
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const size_t probe_count = psi.probes.size();
+        samples.values.reserve(range.count * probe_count);
+        samples.events.reserve(range.count * (probe_count + 1));
+
+        std::vector< char > buffer;
+        auto append = [&](const char* records, size_t n) {
+            pslib::v1_0::append_samples(
+                records, n, probe_count, samples.values, samples.events);
+        };
+        pslib::v1_0::for_each_psd_segment(psi, range,
+            [&](const psd_t& psd, size_t first, size_t count) {
+                return pslib::v1_0::read_psd_records(
+                    psi, psd, first, count, buffer, append);
+            });
+        return samples;
+    }
+
+    // Same as above for a plain psi_t, which is copied into a new
+    // shared_psi_t. Create the shared_psi_t once and pass it instead when
+    // loading several windows of the same recording.
     inline samples_t load_samples(const psi_t& psi,
         std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
-        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1))
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        std::pmr::memory_resource* resource =
+            std::pmr::get_default_resource())
+    {
+        return pslib::v1_0::load_samples(
+            shared_psi_t(psi), begin, end, resource);
+    }
+
+    // Same as load_samples but only the columns selected by projection are
+    // loaded. The probes of the psi of the returned samples are reduced to
+    // the selected probes (in the order given by the projection) and events
+    // holds the events of the selected probes followed by the global event.
+    // If no quantity is selected values stays empty and if no events are
+    // selected events stays empty.
+    inline samples_t load_samples(const shared_psi_t& shared_psi,
+        const projection_t& projection,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        std::pmr::memory_resource* resource =
+            std::pmr::get_default_resource())
     {
+        const psi_t& psi = *shared_psi;
         if (end <= std::chrono::nanoseconds(-1)) {
             end = psi.length();
         }
-        auto samples = pslib::v1_0::samples_t(psi, begin, end);
 
-        std::chrono::nanoseconds current = std::chrono::nanoseconds(0);
-        for (const auto& psd : psi.psds) {
-            auto psd_filename = pslib::v1_0::psd_filename(psi, psd);
-            // Open psd file to read data
-            std::ifstream psd_ifstream(psd_filename, std::ios::binary);
+        std::vector< size_t > probes = projection.probes;
+        if (probes.empty()) {
+            for (size_t i = 0; i < psi.probes.size(); ++i) {
+                probes.push_back(i);
+            }
+        }
+        auto projected_psi = psi;
+        projected_psi.probes.clear();
+        for (auto p : probes) {
+            if (p >= psi.probes.size()) {
+                throw std::out_of_range("Projection selects probe index " +
+                                        std::to_string(p) + " but " +
+                                        psi.filename + " only has " +
+                                        std::to_string(psi.probes.size()) +
+                                        " probes");
+            }
+            projected_psi.probes.push_back(psi.probes[ p ]);
+        }
+        auto samples = pslib::v1_0::samples_t(
+            shared_psi_t(std::move(projected_psi)), begin, end, resource);
 
-            const size_t probe_count = psi.probes.size();
-            auto data_count = psd.data_count;
-            while (psd_ifstream.good() && data_count--) {
-                if (current < begin) {
-                    psd_ifstream.ignore(std::streamsize(
-                        sizeof(pslib::v1_0::data_stream_t) * probe_count +
-                        sizeof(pslib::v1_0::event_t) * (probe_count + 1)));
-                }
-                else if (current > end) {
-                    return samples;
-                }
-                else {
-                    // Read DataStream of each probe
-                    for (size_t i = 0; i < probe_count; ++i) {
-                        auto data_stream = pslib::v1_0::data_stream_t();
-                        psd_ifstream.read(
-                            reinterpret_cast< char* >(&data_stream),
-                            sizeof(data_stream));
-                        samples.values.push_back(std::move(data_stream));
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const size_t probe_count = psi.probes.size();
+        const bool load_values = projection.current || projection.voltage;
+        if (load_values) {
+            samples.values.reserve(range.count * probes.size());
+        }
+        if (projection.events) {
+            samples.events.reserve(range.count * (probes.size() + 1));
+        }
+
+        // Gather the selected columns of each record
+        const double nan = std::numeric_limits< double >::quiet_NaN();
+        const size_t events_offset = sizeof(data_stream_t) * probe_count;
+        auto gather = [&](const char* records, size_t n) {
+            const size_t record_size = pslib::v1_0::sample_size(psi);
+            for (size_t i = 0; i < n; ++i, records += record_size) {
+                if (load_values) {
+                    for (auto p : probes) {
+                        const char* ds = records + sizeof(data_stream_t) * p;
+                        auto value = data_stream_t{ nan, nan };
+                        if (projection.current) {
+                            std::memcpy(&value.current,
+                                ds + offsetof(data_stream_t, current),
+                                sizeof(double));
+                        }
+                        if (projection.voltage) {
+                            std::memcpy(&value.voltage,
+                                ds + offsetof(data_stream_t, voltage),
+                                sizeof(double));
+                        }
+                        samples.values.push_back(value);
                     }
-                    // Read events of each probe and the global event
-                    for (size_t i = 0; i < (probe_count + 1); ++i) {
-                        auto event = pslib::v1_0::event_t();
-                        psd_ifstream.read(
-                            reinterpret_cast< char* >(&event), sizeof(event));
-                        samples.events.push_back(std::move(event));
+                }
+                if (projection.events) {
+                    const char* ev = records + events_offset;
+                    auto event = event_t();
+                    for (auto p : probes) {
+                        std::memcpy(
+                            &event, ev + sizeof(event_t) * p, sizeof(event_t));
+                        samples.events.push_back(event);
                     }
+                    std::memcpy(&event, ev + sizeof(event_t) * probe_count,
+                        sizeof(event_t));
+                    samples.events.push_back(event);
                 }
-                current += psi.sampling_interval();
             }
-        }
+        };
+
+        std::vector< char > buffer;
+        pslib::v1_0::for_each_psd_segment(psi, range,
+            [&](const psd_t& psd, size_t first, size_t count) {
+                return pslib::v1_0::read_psd_records(
+                    psi, psd, first, count, buffer, gather);
+            });
         return samples;
     }
 }
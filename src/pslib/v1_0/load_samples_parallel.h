@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/run_workers.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Default amount of data read by a single worker task
+    constexpr size_t psd_parallel_chunk_size = 64ul * 1024ul * 1024ul;
+
+    // Same as load_samples but the requested range is split into chunks of
+    // (roughly) chunk_size bytes which are read by thread_count workers
+    // directly into their slice of the returned samples.
+    // A thread_count of 0 uses one worker per hardware thread.
+    inline samples_t load_samples_parallel(const shared_psi_t& shared_psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        size_t thread_count = 0, size_t chunk_size = psd_parallel_chunk_size,
+        std::pmr::memory_resource* resource =
+            std::pmr::get_default_resource())
+    {
+        const psi_t& psi = *shared_psi;
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        auto samples = pslib::v1_0::samples_t(shared_psi, begin, end, resource);
+
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const size_t probe_count = psi.probes.size();
+        // Only sizes the storage, its pages are touched first by the worker
+        // reading into them (see sample_allocator)
+        samples.values.resize(range.count * probe_count);
+        samples.events.resize(range.count * (probe_count + 1));
+
+        class task_t {
+            public:
+            const psd_t* psd;
+            // First sample relative to the beginning of the psd
+            size_t first;
+            size_t count;
+            // First sample relative to the beginning of the range
+            size_t destination;
+        };
+        std::vector< task_t > tasks;
+        const auto chunk_count = std::max(
+            chunk_size / pslib::v1_0::sample_size(psi), size_t(1));
+        // End of the samples held by the psds without a gap
+        const auto covered = pslib::v1_0::for_each_psd_segment(psi, range,
+            [&](const psd_t& psd, size_t first, size_t count) {
+                const auto destination =
+                    pslib::v1_0::psd_first_sample(psd) + first - range.first;
+                for (size_t f = 0; f < count; f += chunk_count) {
+                    tasks.push_back(task_t{ &psd, first + f,
+                        std::min(chunk_count, count - f), destination + f });
+                }
+                return count;
+            });
+
+        if (thread_count == 0) {
+            thread_count = std::max(size_t(std::thread::hardware_concurrency()),
+                size_t(1));
+        }
+        thread_count = std::min(thread_count, tasks.size());
+
+        // Number of samples which could be read without a gap, the storage
+        // of the others is never written
+        size_t valid = covered - range.first;
+        std::mutex mutex;
+        std::atomic< size_t > next_task{ 0 };
+        pslib::v1_0::run_workers(thread_count, [&](size_t) {
+            std::vector< char > buffer;
+            for (auto t = next_task++; t < tasks.size(); t = next_task++) {
+                const auto& task = tasks[ t ];
+                const auto n = pslib::v1_0::read_psd(psi, *task.psd,
+                    task.first, task.count,
+                    samples.values.data() + task.destination * probe_count,
+                    samples.events.data() +
+                        task.destination * (probe_count + 1),
+                    buffer);
+                if (n < task.count) {
+                    // Truncated psd file
+                    std::lock_guard< std::mutex > lock(mutex);
+                    valid = std::min(valid, task.destination + n);
+                }
+            }
+        });
+
+        samples.values.resize(valid * probe_count);
+        samples.events.resize(valid * (probe_count + 1));
+        return samples;
+    }
+}
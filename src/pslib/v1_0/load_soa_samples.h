@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/soa_samples_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Scatter count sample records into the columns of soa starting at
+    // sample idx
+    inline void decode_soa_samples(
+        const char* records, size_t count, soa_samples_t& soa, size_t idx)
+    {
+        const size_t probe_count = soa.psi->probes.size();
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t record_size =
+            values_size + sizeof(event_t) * (probe_count + 1);
+        for (size_t p = 0; p < probe_count; ++p) {
+            const char* ds = records + sizeof(data_stream_t) * p;
+            auto current = soa.current[ p ].data() + idx;
+            auto voltage = soa.voltage[ p ].data() + idx;
+            for (size_t i = 0; i < count; ++i, ds += record_size) {
+                std::memcpy(current + i,
+                    ds + offsetof(data_stream_t, current), sizeof(double));
+                std::memcpy(voltage + i,
+                    ds + offsetof(data_stream_t, voltage), sizeof(double));
+            }
+        }
+        for (size_t p = 0; p < probe_count + 1; ++p) {
+            const char* e = records + values_size + sizeof(event_t) * p;
+            auto events = soa.events[ p ].data() + idx;
+            for (size_t i = 0; i < count; ++i, e += record_size) {
+                std::memcpy(events + i, e, sizeof(event_t));
+            }
+        }
+    }
+
+    // Same as load_samples but the samples are stored in the
+    // structure-of-arrays layout
+    inline soa_samples_t load_soa_samples(const shared_psi_t& shared_psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1))
+    {
+        const psi_t& psi = *shared_psi;
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        auto samples = pslib::v1_0::soa_samples_t(shared_psi, begin, end);
+
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        samples.resize(range.count);
+
+        size_t read = 0;
+        std::vector< char > buffer;
+        pslib::v1_0::for_each_psd_segment(psi, range,
+            [&](const psd_t& psd, size_t first, size_t count) {
+                return pslib::v1_0::read_psd_records(psi, psd, first, count,
+                    buffer, [&](const char* records, size_t n) {
+                        pslib::v1_0::decode_soa_samples(
+                            records, n, samples, read);
+                        read += n;
+                    });
+            });
+        samples.resize(read);
+        return samples;
+    }
+}
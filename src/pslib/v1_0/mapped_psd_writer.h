@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/mapped_records_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/save_psi.h"
+#include "pslib/v1_0/write_psd.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    // Incremental writer which maps the .psd files writable, so producers
+    // can fill the sample records in place instead of copying them through
+    // a samples_t and a stream. Every .psd file is created with its final
+    // size of 1 GiB and mapped completely.
+    //
+    // Records are handed out by reserve() and become part of the recording
+    // with commit(). sync() writes the committed records and a .psi file
+    // covering them to the disk and close() writes the final .psi file.
+    class mapped_psd_writer {
+        private:
+        psi_t m_psi;
+        std::string m_directory;
+        std::string m_base_name;
+        size_t m_capacity;
+        size_t m_sample_size;
+        boost::interprocess::mapped_region m_region;
+        bool m_mapped;
+        size_t m_reserved;
+        bool m_closed;
+
+        public:
+        // The sampling rate, checksum and probes are taken from psi, its
+        // sampling count and psds are determined while writing.
+        // A psd_capacity of 0 fills every .psd file as far as possible,
+        // otherwise a new .psd file is started after psd_capacity samples.
+        inline mapped_psd_writer(const psi_t& psi,
+            const std::string& directory, const std::string& base_name,
+            size_t psd_capacity = 0)
+            : m_psi{ psi }
+            , m_directory{ directory }
+            , m_base_name{ base_name }
+            , m_capacity{ pslib::v1_0::psd_sample_capacity(psi) }
+            , m_sample_size{ pslib::v1_0::sample_size(psi) }
+            , m_mapped{ false }
+            , m_reserved{ 0 }
+            , m_closed{ false }
+        {
+            if (psd_capacity > 0) {
+                m_capacity = std::min(m_capacity, psd_capacity);
+            }
+            m_psi.filename = directory + "/" + base_name + ".psi";
+            m_psi.sampling_count = 0;
+            m_psi.psds.clear();
+        }
+
+        mapped_psd_writer(const mapped_psd_writer&) = delete;
+        mapped_psd_writer& operator=(const mapped_psd_writer&) = delete;
+
+        inline ~mapped_psd_writer()
+        {
+            if (!m_closed) {
+                try {
+                    this->close();
+                }
+                catch (...) {
+                }
+            }
+        }
+
+        inline const psi_t& psi() const
+        {
+            return m_psi;
+        }
+
+        // Return up to count writable records following the last committed
+        // one. Fewer records are returned if the current .psd file is almost
+        // full, the next reserve() after committing them continues in a new
+        // .psd file. The records are only part of the recording after
+        // commit().
+        inline mapped_records_t reserve(size_t count)
+        {
+            if (m_closed) {
+                throw std::runtime_error(
+                    "Unable to write to closed " + m_psi.filename);
+            }
+            auto& psd = this->current_psd();
+            m_reserved = std::min(count, m_capacity - size_t(psd.data_count));
+            return mapped_records_t(
+                static_cast< char* >(m_region.get_address()) +
+                    size_t(psd.data_count) * m_sample_size,
+                m_reserved, m_psi.probes.size());
+        }
+
+        // Add the first count records of the last reserve() to the recording
+        inline void commit(size_t count)
+        {
+            if (count > m_reserved) {
+                throw std::runtime_error("Unable to commit " +
+                                         std::to_string(count) +
+                                         " unreserved records to " +
+                                         m_psi.filename);
+            }
+            if (count == 0) {
+                // Nothing may have been reserved (or mapped) yet
+                return;
+            }
+            auto& psd = m_psi.psds.back();
+            const char* records = static_cast< const char* >(
+                                      m_region.get_address()) +
+                                  size_t(psd.data_count) * m_sample_size;
+            psd.data_count += int64_t(count);
+            psd.event_count += pslib::v1_0::count_record_events(
+                records, count, m_psi.probes.size());
+            m_psi.sampling_count += count;
+            m_reserved = 0;
+        }
+
+        // Append count samples where values holds probe_count data streams
+        // and events holds probe_count + 1 events per sample
+        inline void write(
+            const data_stream_t* values, const event_t* events, size_t count)
+        {
+            const size_t probe_count = m_psi.probes.size();
+            while (count > 0) {
+                auto records = this->reserve(count);
+                const auto n = records.size();
+                pslib::v1_0::encode_samples(
+                    values, events, n, probe_count, records.data());
+                this->commit(n);
+                values += n * probe_count;
+                events += n * (probe_count + 1);
+                count -= n;
+            }
+        }
+
+        // Write the committed records to the disk, wait for it and
+        // (atomically) write a .psi file covering them, so the recording can
+        // be loaded up to here even if close() is never reached. Full .psd
+        // files were already synced when they were unmapped.
+        inline void sync()
+        {
+            if (m_closed) {
+                return;
+            }
+            this->flush_psd();
+            pslib::v1_0::replace_psi(m_psi, m_directory, m_base_name);
+        }
+
+        // Unmap the last .psd file and (atomically) write the .psi file
+        inline const psi_t& close()
+        {
+            if (m_closed) {
+                return m_psi;
+            }
+            m_closed = true;
+            this->close_psd();
+            pslib::v1_0::replace_psi(m_psi, m_directory, m_base_name);
+            return m_psi;
+        }
+
+        private:
+        // Return the psd to write to, starting a new one if needed
+        inline psd_t& current_psd()
+        {
+            if (m_mapped &&
+                size_t(m_psi.psds.back().data_count) < m_capacity) {
+                return m_psi.psds.back();
+            }
+            this->close_psd();
+
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = int64_t(m_psi.psds.size() + 1);
+                psd.offset = m_psi.sampling_count > 0
+                                 ? int64_t(m_psi.sampling_count + 1)
+                                 : 0;
+                psd.data_count = 0;
+                psd.event_count = 0;
+            }
+            m_psi.psds.push_back(psd);
+
+            auto psd_filename = pslib::v1_0::psd_filename(m_psi, psd);
+            {
+                std::ofstream psd_file(
+                    psd_filename, std::ios::binary | std::ios::trunc);
+                if (!psd_file.is_open()) {
+                    throw std::runtime_error("Unable to open " + psd_filename);
+                }
+            }
+            boost::filesystem::resize_file(psd_filename, psd_file_size);
+            try {
+                boost::interprocess::file_mapping file(
+                    psd_filename.c_str(), boost::interprocess::read_write);
+                boost::interprocess::mapped_region region(file,
+                    boost::interprocess::read_write, 0,
+                    m_capacity * m_sample_size);
+                m_region.swap(region);
+            }
+            catch (boost::interprocess::interprocess_exception& e) {
+                throw std::runtime_error(
+                    "Unable to map " + psd_filename + ": " + e.what());
+            }
+            m_region.advise(
+                boost::interprocess::mapped_region::advice_sequential);
+            m_mapped = true;
+            return m_psi.psds.back();
+        }
+
+        // Write the mapping of the current .psd file to the disk and wait
+        // for it
+        inline void flush_psd()
+        {
+            if (m_mapped && !m_region.flush(0, 0, false)) {
+                throw std::runtime_error("Unable to sync " +
+                                         pslib::v1_0::psd_filename(
+                                             m_psi, m_psi.psds.back()));
+            }
+        }
+
+        inline void close_psd()
+        {
+            if (!m_mapped) {
+                return;
+            }
+            // A later sync() only covers the current psd
+            this->flush_psd();
+            boost::interprocess::mapped_region().swap(m_region);
+            m_mapped = false;
+            m_reserved = 0;
+        }
+    };
+}
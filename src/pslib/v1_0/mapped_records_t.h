@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+
+// StdLib
+#include <cstddef>
+#include <cstring>
+
+namespace pslib::v1_0 {
+
+    // Writable view on consecutive sample records of a memory mapped .psd
+    // file as handed out by mapped_psd_writer::reserve().
+    //
+    // Depending on the number of probes the records are only 2 byte
+    // aligned, so the data streams and events are accessed through byte
+    // pointers or the (memcpy based) accessors below, never through
+    // data_stream_t or event_t pointers.
+    class mapped_records_t {
+        private:
+        char* m_data;
+        size_t m_count;
+        size_t m_probe_count;
+        size_t m_record_size;
+
+        public:
+        inline mapped_records_t(char* data, size_t count, size_t probe_count)
+            : m_data{ data }
+            , m_count{ count }
+            , m_probe_count{ probe_count }
+            , m_record_size{ sizeof(data_stream_t) * probe_count +
+                             sizeof(event_t) * (probe_count + 1) }
+        {
+        }
+
+        // Number of records in this view
+        inline size_t size() const
+        {
+            return m_count;
+        }
+
+        inline size_t probe_count() const
+        {
+            return m_probe_count;
+        }
+
+        inline size_t record_size() const
+        {
+            return m_record_size;
+        }
+
+        // Raw bytes of the records, e.g. to decode hardware samples into
+        inline char* data() const
+        {
+            return m_data;
+        }
+
+        // Raw bytes of record idx
+        inline char* record(size_t idx) const
+        {
+            return m_data + idx * m_record_size;
+        }
+
+        // Raw bytes of the probe_count data streams of record idx
+        inline char* values(size_t idx) const
+        {
+            return this->record(idx);
+        }
+
+        // Raw bytes of the probe_count + 1 events of record idx, the last
+        // one is the global event
+        inline char* events(size_t idx) const
+        {
+            return this->record(idx) + sizeof(data_stream_t) * m_probe_count;
+        }
+
+        // Data stream of probe in record idx
+        inline data_stream_t value(size_t idx, size_t probe) const
+        {
+            auto ds = pslib::v1_0::data_stream_t();
+            std::memcpy(&ds, this->values(idx) + sizeof(data_stream_t) * probe,
+                sizeof(ds));
+            return ds;
+        }
+
+        inline void set_value(
+            size_t idx, size_t probe, const data_stream_t& ds) const
+        {
+            std::memcpy(this->values(idx) + sizeof(data_stream_t) * probe, &ds,
+                sizeof(ds));
+        }
+
+        // Event of slot (probe_count for the global event) in record idx
+        inline event_t event(size_t idx, size_t slot) const
+        {
+            auto e = pslib::v1_0::event_t();
+            std::memcpy(
+                &e, this->events(idx) + sizeof(event_t) * slot, sizeof(e));
+            return e;
+        }
+
+        inline void set_event(size_t idx, size_t slot, const event_t& e) const
+        {
+            std::memcpy(
+                this->events(idx) + sizeof(event_t) * slot, &e, sizeof(e));
+        }
+    };
+}
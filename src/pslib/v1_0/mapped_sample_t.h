@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/sample_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+namespace pslib::v1_0 {
+    // Read-only view on the record of a single sample in a memory mapped
+    // .psd file as handed out by mapped_samples_t.
+    //
+    // Depending on the number of probes the records are only 2 byte
+    // aligned, so the data streams and events are copied out with memcpy
+    // when accessed instead of handing out pointers into the mapping.
+    class mapped_sample_t {
+        public:
+        std::chrono::nanoseconds time;
+
+        private:
+        const char* m_record;
+        size_t m_probe_count;
+
+        public:
+        inline mapped_sample_t(std::chrono::nanoseconds t, const char* record,
+            size_t probe_count)
+            : time{ t }
+            , m_record{ record }
+            , m_probe_count{ probe_count }
+        {
+        }
+
+        inline size_t probe_count() const
+        {
+            return m_probe_count;
+        }
+
+        // Raw bytes of the record
+        inline const char* record() const
+        {
+            return m_record;
+        }
+
+        // Data stream of probe
+        inline data_stream_t value(size_t probe) const
+        {
+            auto ds = pslib::v1_0::data_stream_t();
+            std::memcpy(
+                &ds, m_record + sizeof(data_stream_t) * probe, sizeof(ds));
+            return ds;
+        }
+
+        // Event of slot (probe_count for the global event)
+        inline event_t event(size_t slot) const
+        {
+            auto e = pslib::v1_0::event_t();
+            std::memcpy(&e,
+                m_record + sizeof(data_stream_t) * m_probe_count +
+                    sizeof(event_t) * slot,
+                sizeof(e));
+            return e;
+        }
+    };
+
+    inline bool operator==(const mapped_sample_t& lhs, const sample_t& rhs)
+    {
+        if (lhs.time != rhs.time) {
+            return false;
+        }
+        if (lhs.probe_count() != rhs.values.size() ||
+            lhs.probe_count() + 1 != rhs.events.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.probe_count(); ++i) {
+            if (lhs.value(i) != rhs.values[ int64_t(i) ]) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i <= lhs.probe_count(); ++i) {
+            if (lhs.event(i) != rhs.events[ int64_t(i) ]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool operator==(const sample_t& lhs, const mapped_sample_t& rhs)
+    {
+        return rhs == lhs;
+    }
+
+    inline bool operator!=(const mapped_sample_t& lhs, const sample_t& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator!=(const sample_t& lhs, const mapped_sample_t& rhs)
+    {
+        return !(rhs == lhs);
+    }
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+// Own
+#include "pslib/v1_0/indexed_iterator.h"
+#include "pslib/v1_0/mapped_sample_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+
+    // Read-only view on the samples of a time range which are memory mapped
+    // directly from the .psd files instead of being copied to the heap.
+    //
+    // at() hands out a mapped_sample_t pointing into the mapping, so
+    // accessing a sample doesn't allocate or copy the record. Like
+    // load_samples the view ends early at a truncated .psd file and a
+    // missing .psd file throws.
+    class mapped_samples_t {
+        public:
+        // Random access iterator over the samples which yields a
+        // mapped_sample_t per sample
+        typedef indexed_iterator< mapped_samples_t, mapped_sample_t >
+            sample_iterator;
+
+        private:
+        class segment_t {
+            public:
+            // Index of the first sample of this segment within the range
+            size_t first;
+            size_t count;
+            const char* data;
+        };
+
+        public:
+        shared_psi_t psi;
+        std::chrono::nanoseconds begin_time;
+        std::chrono::nanoseconds end_time;
+
+        private:
+        sample_range_t m_range;
+        // Number of samples covered by the segments
+        size_t m_count;
+        size_t m_sample_size;
+        std::vector< boost::interprocess::mapped_region > m_regions;
+        std::vector< segment_t > m_segments;
+
+        public:
+        inline mapped_samples_t(const shared_psi_t& p,
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end)
+            : psi{ p }
+            , begin_time{ begin }
+            , end_time{ end }
+            , m_range{ sample_range(*p, begin, end) }
+            , m_count{ 0 }
+            , m_sample_size{ p.record_size() }
+        {
+            m_regions.reserve(p->psds.size());
+            m_segments.reserve(p->psds.size());
+
+            const auto range_end = m_range.first + m_range.count;
+            auto next = m_range.first;
+            for (size_t i = 0; i < p->psds.size() && next < range_end; ++i) {
+                const auto& psd_range = p.psd_ranges()[ i ];
+                const auto psd_begin = psd_range.first_sample;
+                const auto psd_end = psd_begin + psd_range.sample_count;
+                if (psd_end <= next) {
+                    continue;
+                }
+                if (psd_begin > next) {
+                    // No psd holds the sample next
+                    break;
+                }
+                auto last = std::min(psd_end, range_end);
+
+                // Mapping beyond the end of the file would fault on access
+                auto filename = pslib::v1_0::psd_filename(*p, p->psds[ i ]);
+                boost::system::error_code ec;
+                const auto file_size =
+                    size_t(boost::filesystem::file_size(filename, ec));
+                if (ec) {
+                    throw std::runtime_error("Unable to open " + filename);
+                }
+                const auto available = psd_begin + file_size / m_sample_size;
+                last = std::min(last, available);
+                if (last > next) {
+                    try {
+                        boost::interprocess::file_mapping file(
+                            filename.c_str(), boost::interprocess::read_only);
+                        m_regions.emplace_back(file,
+                            boost::interprocess::read_only,
+                            boost::interprocess::offset_t(
+                                (next - psd_begin) * m_sample_size),
+                            (last - next) * m_sample_size);
+                    }
+                    catch (boost::interprocess::interprocess_exception& e) {
+                        throw std::runtime_error(
+                            "Unable to map " + filename + ": " + e.what());
+                    }
+                    m_regions.back().advise(
+                        boost::interprocess::mapped_region::advice_sequential);
+                    m_segments.push_back(segment_t{ next - m_range.first,
+                        last - next,
+                        static_cast< const char* >(
+                            m_regions.back().get_address()) });
+                    next = last;
+                }
+                if (last < std::min(psd_end, range_end)) {
+                    // Truncated psd file
+                    break;
+                }
+            }
+            m_count = next - m_range.first;
+        }
+
+        inline size_t size() const
+        {
+            return m_count;
+        }
+
+        inline mapped_sample_t at(size_t idx) const
+        {
+            if (idx >= m_count) {
+                throw std::out_of_range("Sample index " + std::to_string(idx) +
+                                        " is out of range");
+            }
+            auto segment = std::upper_bound(m_segments.begin(),
+                m_segments.end(), idx, [](size_t i, const segment_t& s) {
+                    return i < s.first;
+                });
+            if (segment == m_segments.begin() ||
+                idx >= (segment - 1)->first + (segment - 1)->count) {
+                throw std::out_of_range("Sample index " + std::to_string(idx) +
+                                        " isn't mapped");
+            }
+            --segment;
+
+            return mapped_sample_t(
+                (m_range.first + idx) * this->psi.interval(),
+                segment->data + (idx - segment->first) * m_sample_size,
+                this->psi.probe_count());
+        }
+
+        inline mapped_sample_t operator[](size_t idx) const
+        {
+            return this->at(idx);
+        }
+
+        inline sample_iterator begin() const
+        {
+            return sample_iterator(0, this);
+        }
+
+        inline sample_iterator end() const
+        {
+            return sample_iterator(this->size(), this);
+        }
+    };
+}
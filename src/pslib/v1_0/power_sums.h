@@ -0,0 +1,449 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/compensated_sum_t.h"
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pslib::v1_0 {
+    // Least and greatest number of vectors the power kernels process at
+    // once, the kernels need an even number of them
+    constexpr size_t power_sums_min_vectors = 2;
+    constexpr size_t power_sums_max_vectors = 16;
+
+    // Fill lanes (one per double of a chunk of vectors vectors of width
+    // doubles) from the accumulators of a kernel. Lane q of accumulator m
+    // holds the power of the data_stream_t starting at lane 2 * (q / 2) of
+    // vector 2 * m + q % 2.
+    inline void store_power_lanes(size_t vectors, size_t width,
+        const double* sum, const double* compensation,
+        compensated_sum_t* lanes)
+    {
+        for (size_t m = 0; m < vectors / 2; ++m) {
+            for (size_t q = 0; q < width; ++q) {
+                const auto i = m * width + q;
+                auto& lane = lanes[ (2 * m + q % 2) * width + 2 * (q / 2) ];
+                lane.sum = sum[ i ];
+                lane.compensation = compensation[ i ];
+            }
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // The kernels sum up current * voltage of interleaved data_stream_t in
+    // chunks of K vectors. Unpacking two vectors separates their currents
+    // from their voltages, so one multiplication yields a power in every
+    // lane. The rounding error of every addition is collected branch-free
+    // with TwoSum, which yields the same compensation as compensated_sum_t.
+    // With FMA the exact rounding error of every product is collected as
+    // well.
+    template < size_t K >
+    __attribute__((target("sse2"))) inline void power_sums_sse2(
+        const double* data, size_t chunks, compensated_sum_t* lanes)
+    {
+        constexpr size_t W = 2;
+        __m128d sums[ K / 2 ], compensations[ K / 2 ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            sums[ m ] = compensations[ m ] = _mm_setzero_pd();
+        }
+        for (size_t c = 0; c < chunks; ++c, data += K * W) {
+#pragma GCC unroll 8
+            for (size_t m = 0; m < K / 2; ++m) {
+                const auto x0 = _mm_loadu_pd(data + 2 * m * W);
+                const auto x1 = _mm_loadu_pd(data + (2 * m + 1) * W);
+                const auto current = _mm_unpacklo_pd(x0, x1);
+                const auto voltage = _mm_unpackhi_pd(x0, x1);
+                const auto p = _mm_mul_pd(current, voltage);
+                const auto t = _mm_add_pd(sums[ m ], p);
+                const auto z = _mm_sub_pd(t, sums[ m ]);
+                const auto s_error = _mm_add_pd(
+                    _mm_sub_pd(sums[ m ], _mm_sub_pd(t, z)),
+                    _mm_sub_pd(p, z));
+                compensations[ m ] = _mm_add_pd(compensations[ m ], s_error);
+                sums[ m ] = t;
+            }
+        }
+        double out[ 2 ][ K / 2 * W ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            _mm_storeu_pd(out[ 0 ] + m * W, sums[ m ]);
+            _mm_storeu_pd(out[ 1 ] + m * W, compensations[ m ]);
+        }
+        pslib::v1_0::store_power_lanes(K, W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    template < size_t K >
+    __attribute__((target("avx2,fma"))) inline void power_sums_avx2(
+        const double* data, size_t chunks, compensated_sum_t* lanes)
+    {
+        constexpr size_t W = 4;
+        __m256d sums[ K / 2 ], compensations[ K / 2 ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            sums[ m ] = compensations[ m ] = _mm256_setzero_pd();
+        }
+        for (size_t c = 0; c < chunks; ++c, data += K * W) {
+#pragma GCC unroll 8
+            for (size_t m = 0; m < K / 2; ++m) {
+                const auto x0 = _mm256_loadu_pd(data + 2 * m * W);
+                const auto x1 = _mm256_loadu_pd(data + (2 * m + 1) * W);
+                const auto current = _mm256_unpacklo_pd(x0, x1);
+                const auto voltage = _mm256_unpackhi_pd(x0, x1);
+                const auto p = _mm256_mul_pd(current, voltage);
+                const auto p_error = _mm256_fmsub_pd(current, voltage, p);
+                const auto t = _mm256_add_pd(sums[ m ], p);
+                const auto z = _mm256_sub_pd(t, sums[ m ]);
+                const auto s_error = _mm256_add_pd(
+                    _mm256_sub_pd(sums[ m ], _mm256_sub_pd(t, z)),
+                    _mm256_sub_pd(p, z));
+                compensations[ m ] = _mm256_add_pd(
+                    compensations[ m ], _mm256_add_pd(s_error, p_error));
+                sums[ m ] = t;
+            }
+        }
+        double out[ 2 ][ K / 2 * W ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            _mm256_storeu_pd(out[ 0 ] + m * W, sums[ m ]);
+            _mm256_storeu_pd(out[ 1 ] + m * W, compensations[ m ]);
+        }
+        pslib::v1_0::store_power_lanes(K, W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    template < size_t K >
+    __attribute__((target("avx512f"))) inline void power_sums_avx512(
+        const double* data, size_t chunks, compensated_sum_t* lanes)
+    {
+        constexpr size_t W = 8;
+        const auto all = __mmask8(0xFF);
+        __m512d sums[ K / 2 ], compensations[ K / 2 ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            sums[ m ] = compensations[ m ] = _mm512_setzero_pd();
+        }
+        for (size_t c = 0; c < chunks; ++c, data += K * W) {
+#pragma GCC unroll 8
+            for (size_t m = 0; m < K / 2; ++m) {
+                const auto x0 = _mm512_loadu_pd(data + 2 * m * W);
+                const auto x1 = _mm512_loadu_pd(data + (2 * m + 1) * W);
+                // The masked forms avoid the undefined pass-through operand
+                // of _mm512_unpacklo_pd/_mm512_unpackhi_pd
+                const auto current = _mm512_mask_unpacklo_pd(x0, all, x0, x1);
+                const auto voltage = _mm512_mask_unpackhi_pd(x0, all, x0, x1);
+                const auto p = _mm512_mul_pd(current, voltage);
+                const auto p_error = _mm512_fmsub_pd(current, voltage, p);
+                const auto t = _mm512_add_pd(sums[ m ], p);
+                const auto z = _mm512_sub_pd(t, sums[ m ]);
+                const auto s_error = _mm512_add_pd(
+                    _mm512_sub_pd(sums[ m ], _mm512_sub_pd(t, z)),
+                    _mm512_sub_pd(p, z));
+                compensations[ m ] = _mm512_add_pd(
+                    compensations[ m ], _mm512_add_pd(s_error, p_error));
+                sums[ m ] = t;
+            }
+        }
+        double out[ 2 ][ K / 2 * W ];
+        for (size_t m = 0; m < K / 2; ++m) {
+            _mm512_storeu_pd(out[ 0 ] + m * W, sums[ m ]);
+            _mm512_storeu_pd(out[ 1 ] + m * W, compensations[ m ]);
+        }
+        pslib::v1_0::store_power_lanes(K, W, out[ 0 ], out[ 1 ], lanes);
+    }
+
+    // The column kernels sum up current[ i ] * voltage[ i ] of count values
+    // with 4 vectors in flight and return the rows they processed
+    __attribute__((target("sse2"))) inline size_t power_sum_columns_sse2(
+        const double* current, const double* voltage, size_t count,
+        compensated_sum_t& sum)
+    {
+        constexpr size_t W = 2;
+        constexpr size_t K = 4;
+        __m128d sums[ K ], compensations[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            sums[ j ] = compensations[ j ] = _mm_setzero_pd();
+        }
+        size_t i = 0;
+        for (; i + K * W <= count; i += K * W) {
+#pragma GCC unroll 4
+            for (size_t j = 0; j < K; ++j) {
+                const auto x = _mm_loadu_pd(current + i + j * W);
+                const auto y = _mm_loadu_pd(voltage + i + j * W);
+                const auto p = _mm_mul_pd(x, y);
+                const auto t = _mm_add_pd(sums[ j ], p);
+                const auto z = _mm_sub_pd(t, sums[ j ]);
+                const auto s_error = _mm_add_pd(
+                    _mm_sub_pd(sums[ j ], _mm_sub_pd(t, z)),
+                    _mm_sub_pd(p, z));
+                compensations[ j ] = _mm_add_pd(compensations[ j ], s_error);
+                sums[ j ] = t;
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+            _mm_storeu_pd(out[ 1 ] + j * W, compensations[ j ]);
+        }
+        for (size_t l = 0; l < K * W; ++l) {
+            sum.add(compensated_sum_t{ out[ 0 ][ l ], out[ 1 ][ l ] });
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2,fma"))) inline size_t power_sum_columns_avx2(
+        const double* current, const double* voltage, size_t count,
+        compensated_sum_t& sum)
+    {
+        constexpr size_t W = 4;
+        constexpr size_t K = 4;
+        __m256d sums[ K ], compensations[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            sums[ j ] = compensations[ j ] = _mm256_setzero_pd();
+        }
+        size_t i = 0;
+        for (; i + K * W <= count; i += K * W) {
+#pragma GCC unroll 4
+            for (size_t j = 0; j < K; ++j) {
+                const auto x = _mm256_loadu_pd(current + i + j * W);
+                const auto y = _mm256_loadu_pd(voltage + i + j * W);
+                const auto p = _mm256_mul_pd(x, y);
+                const auto p_error = _mm256_fmsub_pd(x, y, p);
+                const auto t = _mm256_add_pd(sums[ j ], p);
+                const auto z = _mm256_sub_pd(t, sums[ j ]);
+                const auto s_error = _mm256_add_pd(
+                    _mm256_sub_pd(sums[ j ], _mm256_sub_pd(t, z)),
+                    _mm256_sub_pd(p, z));
+                compensations[ j ] = _mm256_add_pd(
+                    compensations[ j ], _mm256_add_pd(s_error, p_error));
+                sums[ j ] = t;
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm256_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+            _mm256_storeu_pd(out[ 1 ] + j * W, compensations[ j ]);
+        }
+        for (size_t l = 0; l < K * W; ++l) {
+            sum.add(compensated_sum_t{ out[ 0 ][ l ], out[ 1 ][ l ] });
+        }
+        return i;
+    }
+
+    __attribute__((target("avx512f"))) inline size_t power_sum_columns_avx512(
+        const double* current, const double* voltage, size_t count,
+        compensated_sum_t& sum)
+    {
+        constexpr size_t W = 8;
+        constexpr size_t K = 4;
+        __m512d sums[ K ], compensations[ K ];
+        for (size_t j = 0; j < K; ++j) {
+            sums[ j ] = compensations[ j ] = _mm512_setzero_pd();
+        }
+        size_t i = 0;
+        for (; i + K * W <= count; i += K * W) {
+#pragma GCC unroll 4
+            for (size_t j = 0; j < K; ++j) {
+                const auto x = _mm512_loadu_pd(current + i + j * W);
+                const auto y = _mm512_loadu_pd(voltage + i + j * W);
+                const auto p = _mm512_mul_pd(x, y);
+                const auto p_error = _mm512_fmsub_pd(x, y, p);
+                const auto t = _mm512_add_pd(sums[ j ], p);
+                const auto z = _mm512_sub_pd(t, sums[ j ]);
+                const auto s_error = _mm512_add_pd(
+                    _mm512_sub_pd(sums[ j ], _mm512_sub_pd(t, z)),
+                    _mm512_sub_pd(p, z));
+                compensations[ j ] = _mm512_add_pd(
+                    compensations[ j ], _mm512_add_pd(s_error, p_error));
+                sums[ j ] = t;
+            }
+        }
+        double out[ 2 ][ K * W ];
+        for (size_t j = 0; j < K; ++j) {
+            _mm512_storeu_pd(out[ 0 ] + j * W, sums[ j ]);
+            _mm512_storeu_pd(out[ 1 ] + j * W, compensations[ j ]);
+        }
+        for (size_t l = 0; l < K * W; ++l) {
+            sum.add(compensated_sum_t{ out[ 0 ][ l ], out[ 1 ][ l ] });
+        }
+        return i;
+    }
+
+    // Run the kernel of isa with vectors accumulators
+    inline void power_sums_kernel(SIMD_ISA isa, size_t vectors,
+        const double* data, size_t chunks, compensated_sum_t* lanes)
+    {
+        typedef void (*kernel_t)(const double*, size_t, compensated_sum_t*);
+        static const kernel_t kernels[ 3 ][ 8 ] = {
+            { &power_sums_sse2< 2 >, &power_sums_sse2< 4 >,
+                &power_sums_sse2< 6 >, &power_sums_sse2< 8 >,
+                &power_sums_sse2< 10 >, &power_sums_sse2< 12 >,
+                &power_sums_sse2< 14 >, &power_sums_sse2< 16 > },
+            { &power_sums_avx2< 2 >, &power_sums_avx2< 4 >,
+                &power_sums_avx2< 6 >, &power_sums_avx2< 8 >,
+                &power_sums_avx2< 10 >, &power_sums_avx2< 12 >,
+                &power_sums_avx2< 14 >, &power_sums_avx2< 16 > },
+            { &power_sums_avx512< 2 >, &power_sums_avx512< 4 >,
+                &power_sums_avx512< 6 >, &power_sums_avx512< 8 >,
+                &power_sums_avx512< 10 >, &power_sums_avx512< 12 >,
+                &power_sums_avx512< 14 >, &power_sums_avx512< 16 > }
+        };
+        const size_t row = isa == SIMD_ISA::AVX512 ? 2
+                           : isa == SIMD_ISA::AVX2 ? 1
+                                                   : 0;
+        kernels[ row ][ (vectors - power_sums_min_vectors) / 2 ](
+            data, chunks, lanes);
+    }
+#endif
+
+    // Add the power of probe (current * voltage) of count interleaved
+    // samples to sum and count the NaN powers in nan_count. With
+    // NAN_POLICY::SKIP NaN powers are left out of the sum.
+    inline void add_power_sum_scalar(const double* data, size_t count,
+        size_t probe_count, size_t probe, compensated_sum_t& sum,
+        uint64_t& nan_count, NAN_POLICY policy)
+    {
+        const double* ds = data + 2 * probe;
+        for (size_t i = 0; i < count; ++i, ds += 2 * probe_count) {
+            const auto p = ds[ 0 ] * ds[ 1 ];
+            if (std::isnan(p)) {
+                nan_count++;
+                if (policy == NAN_POLICY::SKIP) {
+                    continue;
+                }
+            }
+            sum.add(p);
+        }
+    }
+
+    // Add the power of every probe of count interleaved samples (the
+    // doubles of probe_count data_stream_t each) to sums and count the NaN
+    // powers in nan_counts. The sums are vectorized with isa (or the best
+    // instruction set of the CPU below it) for up to 8 probes, the samples
+    // of a probe are only summed up again one by one if its sum is NaN.
+    inline void add_power_sums(const double* data, size_t count,
+        size_t probe_count, compensated_sum_t* sums, uint64_t* nan_counts,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (probe_count == 0) {
+            return;
+        }
+        const size_t columns = 2 * probe_count;
+        std::vector< compensated_sum_t > probe_sums(probe_count);
+        size_t row = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (!pslib::v1_0::simd_isa_supported(isa)) {
+            isa = pslib::v1_0::cpu_simd_isa();
+        }
+        if (isa != SIMD_ISA::SCALAR) {
+            // A chunk spans whole rows and whole vectors, so every lane of
+            // the kernel always sees values of the same column
+            const auto width = pslib::v1_0::simd_width(isa);
+            auto vectors = std::lcm(columns, width) / width;
+            vectors *= vectors % 2 == 1 ? 2 : 1;
+            const auto chunk = vectors * width;
+            const auto chunks = count * columns / chunk;
+            if (vectors <= power_sums_max_vectors && chunks > 0) {
+                std::vector< compensated_sum_t > lanes(chunk);
+                pslib::v1_0::power_sums_kernel(
+                    isa, vectors, data, chunks, lanes.data());
+                for (size_t i = 0; i < chunk; i += 2) {
+                    probe_sums[ (i % columns) / 2 ].add(lanes[ i ]);
+                }
+                row = chunks * chunk / columns;
+            }
+        }
+#endif
+        for (; row < count; ++row) {
+            const double* ds = data + row * columns;
+            for (size_t p = 0; p < probe_count; ++p) {
+                probe_sums[ p ].add(ds[ 2 * p ] * ds[ 2 * p + 1 ]);
+            }
+        }
+        for (size_t p = 0; p < probe_count; ++p) {
+            if (std::isnan(probe_sums[ p ].value())) {
+                probe_sums[ p ] = compensated_sum_t();
+                pslib::v1_0::add_power_sum_scalar(data, count, probe_count,
+                    p, probe_sums[ p ], nan_counts[ p ], policy);
+            }
+            sums[ p ].add(probe_sums[ p ]);
+        }
+    }
+
+    // Same as add_power_sums for a single probe stored in two columns
+    inline void add_power_sum(const double* current, const double* voltage,
+        size_t count, compensated_sum_t& sum, uint64_t& nan_count,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        auto column_sum = compensated_sum_t();
+        size_t i = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (!pslib::v1_0::simd_isa_supported(isa)) {
+            isa = pslib::v1_0::cpu_simd_isa();
+        }
+        switch (isa) {
+            case SIMD_ISA::SSE2:
+                i = pslib::v1_0::power_sum_columns_sse2(
+                    current, voltage, count, column_sum);
+                break;
+            case SIMD_ISA::AVX2:
+                i = pslib::v1_0::power_sum_columns_avx2(
+                    current, voltage, count, column_sum);
+                break;
+            case SIMD_ISA::AVX512:
+                i = pslib::v1_0::power_sum_columns_avx512(
+                    current, voltage, count, column_sum);
+                break;
+            case SIMD_ISA::SCALAR:
+            default:
+                break;
+        }
+#endif
+        for (; i < count; ++i) {
+            column_sum.add(current[ i ] * voltage[ i ]);
+        }
+        if (std::isnan(column_sum.value())) {
+            column_sum = compensated_sum_t();
+            for (i = 0; i < count; ++i) {
+                const auto p = current[ i ] * voltage[ i ];
+                if (std::isnan(p)) {
+                    nan_count++;
+                    if (policy == NAN_POLICY::SKIP) {
+                        continue;
+                    }
+                }
+                column_sum.add(p);
+            }
+        }
+        sum.add(column_sum);
+    }
+}
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_block_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Same as sample_reader but a background thread reads up to queue_depth
+    // blocks ahead while the consumer processes the current one.
+    // A queue_depth of 1 is plain double buffering.
+    class prefetch_sample_reader {
+        private:
+        sample_reader m_reader;
+        std::vector< sample_block_t > m_blocks;
+        // Blocks filled by the background thread in reading order
+        std::deque< sample_block_t* > m_filled;
+        // Blocks which may be (re)filled by the background thread
+        std::deque< sample_block_t* > m_free;
+        // Block currently handed out to the consumer
+        sample_block_t* m_current;
+        bool m_done;
+        bool m_stop;
+        std::exception_ptr m_error;
+        std::mutex m_mutex;
+        std::condition_variable m_filled_cv;
+        std::condition_variable m_free_cv;
+        std::thread m_thread;
+
+        public:
+        inline prefetch_sample_reader(const shared_psi_t& psi,
+            std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+            std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+            size_t block_size = sample_reader_block_size,
+            size_t queue_depth = 2)
+            : m_reader{ psi, begin, end, block_size }
+            , m_blocks(std::max(queue_depth, size_t(1)) + 1)
+            , m_current{ nullptr }
+            , m_done{ false }
+            , m_stop{ false }
+        {
+            for (auto& block : m_blocks) {
+                m_free.push_back(&block);
+            }
+            m_thread = std::thread([this]() { this->prefetch(); });
+        }
+
+        prefetch_sample_reader(const prefetch_sample_reader&) = delete;
+        prefetch_sample_reader& operator=(
+            const prefetch_sample_reader&) = delete;
+
+        inline ~prefetch_sample_reader()
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_stop = true;
+            }
+            m_free_cv.notify_all();
+            m_thread.join();
+        }
+
+        inline const psi_t& psi() const
+        {
+            return m_reader.psi();
+        }
+
+        // Return the next block or nullptr if all samples were read.
+        // The returned block stays valid until the next call.
+        // Errors of the background thread are rethrown here.
+        inline const sample_block_t* next()
+        {
+            std::unique_lock< std::mutex > lock(m_mutex);
+            if (m_current != nullptr) {
+                m_free.push_back(m_current);
+                m_current = nullptr;
+                m_free_cv.notify_one();
+            }
+            m_filled_cv.wait(
+                lock, [this]() { return !m_filled.empty() || m_done; });
+            if (!m_filled.empty()) {
+                m_current = m_filled.front();
+                m_filled.pop_front();
+                return m_current;
+            }
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+            return nullptr;
+        }
+
+        private:
+        inline void prefetch()
+        {
+            try {
+                while (true) {
+                    sample_block_t* block = nullptr;
+                    {
+                        std::unique_lock< std::mutex > lock(m_mutex);
+                        m_free_cv.wait(lock,
+                            [this]() { return !m_free.empty() || m_stop; });
+                        if (m_stop) {
+                            break;
+                        }
+                        block = m_free.front();
+                        m_free.pop_front();
+                    }
+
+                    // Read without holding the lock
+                    const bool read = m_reader.read(*block);
+
+                    std::lock_guard< std::mutex > lock(m_mutex);
+                    if (!read) {
+                        m_free.push_back(block);
+                        break;
+                    }
+                    m_filled.push_back(block);
+                    m_filled_cv.notify_one();
+                }
+            }
+            catch (...) {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_error = std::current_exception();
+            }
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_done = true;
+            }
+            m_filled_cv.notify_all();
+        }
+    };
+}
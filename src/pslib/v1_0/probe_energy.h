@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/energy_t.h"
+#include "pslib/v1_0/power_sums.h"
+#include "pslib/v1_0/sample_block_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/soa_samples_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Return the power (current * voltage) of probe for every sample
+    inline std::vector< double > power_series(
+        const samples_t& samples, size_t probe)
+    {
+        const size_t probe_count = samples.psi.probe_count();
+        if (probe >= probe_count) {
+            throw std::runtime_error("Invalid probe");
+        }
+        // Samples holding events only have no power
+        std::vector< double > power(
+            samples.values.empty() ? 0 : samples.size());
+        const data_stream_t* ds = samples.values.data() + probe;
+        for (size_t i = 0; i < power.size(); ++i, ds += probe_count) {
+            power[ i ] = ds->current * ds->voltage;
+        }
+        return power;
+    }
+
+    // Return the power (current * voltage) of probe for every sample
+    inline std::vector< double > power_series(
+        const soa_samples_t& samples, size_t probe)
+    {
+        if (probe >= samples.current.size()) {
+            throw std::runtime_error("Invalid probe");
+        }
+        // The columns are empty for samples holding events only
+        std::vector< double > power(std::min(
+            samples.current[ probe ].size(), samples.voltage[ probe ].size()));
+        const auto current = samples.current[ probe ].data();
+        const auto voltage = samples.voltage[ probe ].data();
+        for (size_t i = 0; i < power.size(); ++i) {
+            power[ i ] = current[ i ] * voltage[ i ];
+        }
+        return power;
+    }
+
+    // Add the energy of count interleaved samples (probe_count
+    // data_stream_t each) starting at values to energies, which holds one
+    // probe_energy_t per probe. With NAN_POLICY::SKIP samples with NaN
+    // power count as 0 W.
+    inline void add_probe_energy(const data_stream_t* values, size_t count,
+        std::chrono::duration< double > interval,
+        std::vector< probe_energy_t >& energies,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (count == 0) {
+            return;
+        }
+        const size_t probe_count = energies.size();
+        std::vector< compensated_sum_t > sums(probe_count);
+        std::vector< uint64_t > nan_counts(probe_count, 0);
+        pslib::v1_0::add_power_sums(reinterpret_cast< const double* >(values),
+            count, probe_count, sums.data(), nan_counts.data(), policy, isa);
+
+        auto power = [&](const data_stream_t& ds) {
+            const auto p = ds.current * ds.voltage;
+            return std::isnan(p) && policy == NAN_POLICY::SKIP ? 0.0 : p;
+        };
+        for (size_t p = 0; p < probe_count; ++p) {
+            auto energy = probe_energy_t();
+            {
+                energy.interval = interval;
+                energy.count = count;
+                energy.nan_count = nan_counts[ p ];
+                energy.first_power = power(values[ p ]);
+                energy.last_power =
+                    power(values[ (count - 1) * probe_count + p ]);
+                energy.power_sum = sums[ p ];
+            }
+            energies[ p ].add(energy);
+        }
+    }
+
+    // Add the energy of a block handed out by a sample reader to energies
+    inline void add_probe_energy(const sample_block_t& block,
+        std::vector< probe_energy_t >& energies,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (energies.size() != block.probe_count) {
+            throw std::runtime_error("Probe count mismatch");
+        }
+        pslib::v1_0::add_probe_energy(block.values.data(), block.size(),
+            block.exact_interval, energies, policy, isa);
+    }
+
+    // Return the energy of each probe over all samples
+    inline std::vector< probe_energy_t > probe_energy(const samples_t& samples,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_energy_t > energies(samples.psi.probe_count());
+        if (samples.values.empty()) {
+            // Samples holding events only
+            return energies;
+        }
+        pslib::v1_0::add_probe_energy(samples.values.data(), samples.size(),
+            samples.psi.exact_interval(), energies, policy, isa);
+        return energies;
+    }
+
+    // Return the energy of each probe over the samples with a time in
+    // [begin, end]
+    inline std::vector< probe_energy_t > probe_energy(const samples_t& samples,
+        std::chrono::nanoseconds begin, std::chrono::nanoseconds end,
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_energy_t > energies(samples.psi.probe_count());
+        const auto slice = samples.slice(begin, end);
+        if (slice.size() > 0 && !slice[ 0 ].values.empty()) {
+            pslib::v1_0::add_probe_energy(slice[ 0 ].values.data(),
+                slice.size(), samples.psi.exact_interval(), energies, policy,
+                isa);
+        }
+        return energies;
+    }
+
+    // Return the energy of each probe over all samples
+    inline std::vector< probe_energy_t > probe_energy(
+        const soa_samples_t& samples, NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_energy_t > energies(samples.current.size());
+        for (size_t p = 0; p < energies.size(); ++p) {
+            // The columns are empty for samples holding events only
+            const size_t count = std::min(
+                samples.current[ p ].size(), samples.voltage[ p ].size());
+            if (count == 0) {
+                continue;
+            }
+            const auto current = samples.current[ p ].data();
+            const auto voltage = samples.voltage[ p ].data();
+            auto power = [&](size_t i) {
+                const auto v = current[ i ] * voltage[ i ];
+                return std::isnan(v) && policy == NAN_POLICY::SKIP ? 0.0 : v;
+            };
+            auto& energy = energies[ p ];
+            energy.interval = samples.psi.exact_interval();
+            energy.count = count;
+            energy.first_power = power(0);
+            energy.last_power = power(count - 1);
+            pslib::v1_0::add_power_sum(current, voltage, count,
+                energy.power_sum, energy.nan_count, policy, isa);
+        }
+        return energies;
+    }
+
+    // Return the energy of each probe over the samples in [begin, end]
+    // (same as load_samples) by streaming the .psd files block by block
+    // instead of loading the whole range into memory
+    inline std::vector< probe_energy_t > probe_energy(const shared_psi_t& psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_energy_t > energies(psi.probe_count());
+        auto reader = pslib::v1_0::sample_reader(psi, begin, end);
+        while (auto block = reader.next()) {
+            pslib::v1_0::add_probe_energy(*block, energies, policy, isa);
+        }
+        return energies;
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/column_statistics.h"
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/sample_block_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/simd_isa.h"
+#include "pslib/v1_0/soa_samples_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Add count interleaved samples (probe_count data_stream_t each) starting
+    // at values to the probe_count probe_statistics_t at stats
+    inline void add_probe_statistics(const data_stream_t* values,
+        size_t count, probe_statistics_t* stats, size_t probe_count,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (count == 0 || probe_count == 0) {
+            return;
+        }
+        // Column 2p holds the current and column 2p + 1 the voltage of
+        // probe p
+        std::vector< statistics_t > columns(2 * probe_count);
+        pslib::v1_0::add_column_statistics(
+            reinterpret_cast< const double* >(values), count,
+            2 * probe_count, columns.data(), isa);
+        for (size_t p = 0; p < probe_count; ++p) {
+            stats[ p ].current.add(columns[ 2 * p ]);
+            stats[ p ].voltage.add(columns[ 2 * p + 1 ]);
+        }
+    }
+
+    // Add count interleaved samples (probe_count data_stream_t each) starting
+    // at values to stats, which holds one probe_statistics_t per probe
+    inline void add_probe_statistics(const data_stream_t* values,
+        size_t count, std::vector< probe_statistics_t >& stats,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        pslib::v1_0::add_probe_statistics(
+            values, count, stats.data(), stats.size(), isa);
+    }
+
+    // Add the samples of a block handed out by a sample reader to stats
+    inline void add_probe_statistics(const sample_block_t& block,
+        std::vector< probe_statistics_t >& stats,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        if (stats.size() != block.probe_count) {
+            throw std::runtime_error("Probe count mismatch");
+        }
+        if (block.values.empty()) {
+            // Samples holding events only
+            return;
+        }
+        pslib::v1_0::add_probe_statistics(
+            block.values.data(), block.size(), stats, isa);
+    }
+
+    // Return the statistics of each probe over all samples
+    inline std::vector< probe_statistics_t > probe_statistics(
+        const samples_t& samples, NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_statistics_t > stats(samples.psi.probe_count());
+        if (!samples.values.empty()) {
+            pslib::v1_0::add_probe_statistics(
+                samples.values.data(), samples.size(), stats, isa);
+        }
+        for (auto& s : stats) {
+            s.apply(policy);
+        }
+        return stats;
+    }
+
+    // Return the statistics of each probe over a slice of samples
+    inline std::vector< probe_statistics_t > probe_statistics(
+        const samples_t::slice_t& slice, NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_statistics_t > stats(slice.psi().probe_count());
+        if (slice.size() > 0 && !slice[ 0 ].values.empty()) {
+            pslib::v1_0::add_probe_statistics(
+                slice[ 0 ].values.data(), slice.size(), stats, isa);
+        }
+        for (auto& s : stats) {
+            s.apply(policy);
+        }
+        return stats;
+    }
+
+    // Return the statistics of each probe over all samples, every column is
+    // processed on its own
+    inline std::vector< probe_statistics_t > probe_statistics(
+        const soa_samples_t& samples, NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_statistics_t > stats(samples.current.size());
+        for (size_t p = 0; p < stats.size(); ++p) {
+            // The columns are empty for samples holding events only
+            pslib::v1_0::add_column_statistics(samples.current[ p ].data(),
+                samples.current[ p ].size(), 1, &stats[ p ].current, isa);
+            pslib::v1_0::add_column_statistics(samples.voltage[ p ].data(),
+                samples.voltage[ p ].size(), 1, &stats[ p ].voltage, isa);
+            stats[ p ].apply(policy);
+        }
+        return stats;
+    }
+
+    // Return the statistics of each probe over the samples in [begin, end]
+    // (same as load_samples) by streaming the .psd files block by block
+    // instead of loading the whole range into memory
+    inline std::vector< probe_statistics_t > probe_statistics(
+        const shared_psi_t& psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        NAN_POLICY policy = NAN_POLICY::SKIP,
+        SIMD_ISA isa = pslib::v1_0::cpu_simd_isa())
+    {
+        std::vector< probe_statistics_t > stats(psi.probe_count());
+        auto reader = pslib::v1_0::sample_reader(psi, begin, end);
+        while (auto block = reader.next()) {
+            pslib::v1_0::add_probe_statistics(*block, stats, isa);
+        }
+        for (auto& s : stats) {
+            s.apply(policy);
+        }
+        return stats;
+    }
+}
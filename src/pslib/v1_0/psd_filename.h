@@ -35,4 +35,12 @@ namespace pslib::v1_0 {
         return psi.filename.substr(0, psi.filename.size() - 4) + "_" +
                std::to_string(psd.id) + ".psd";
     }
+
+    // Return the filename of a sidecar file with the given extension (e.g.
+    // ".psx") next to the .psi file of psi
+    inline std::string psi_sidecar_filename(
+        const psi_t& psi, const std::string& extension)
+    {
+        return psi.filename.substr(0, psi.filename.size() - 4) + extension;
+    }
 }
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace pslib::v1_0 {
+    // Every .psd file is padded to this size
+    constexpr uint64_t psd_file_size = 1ul * 1024ul * 1024ul * 1024ul;
+
+    // Return the size in bytes of a single sample record in a .psd file.
+    // A record holds one data_stream_t per probe followed by one event_t per
+    // probe and the global event.
+    inline size_t sample_size(const psi_t& psi)
+    {
+        return sizeof(pslib::v1_0::data_stream_t) * psi.probes.size() +
+               sizeof(pslib::v1_0::event_t) * (psi.probes.size() + 1);
+    }
+
+    // Return the maximum number of samples a single .psd file can hold
+    inline size_t psd_sample_capacity(const psi_t& psi)
+    {
+        return size_t(psd_file_size) / sample_size(psi);
+    }
+
+    // Return the index of the first sample stored in the given psd.
+    // The offset of every psd except the first one is 1-based.
+    inline size_t psd_first_sample(const psd_t& psd)
+    {
+        return psd.offset > 0 ? size_t(psd.offset - 1) : 0;
+    }
+
+    // Return the number of samples stored in all psds
+    inline size_t psd_sample_count(const psi_t& psi)
+    {
+        size_t count = 0;
+        for (const auto& psd : psi.psds) {
+            count += size_t(psd.data_count);
+        }
+        return count;
+    }
+
+    // Return the index into psi.psds of the psd holding the given sample or
+    // psi.psds.size() if no psd holds it
+    inline size_t psd_index(const psi_t& psi, size_t sample_idx)
+    {
+        auto it = std::upper_bound(psi.psds.begin(), psi.psds.end(),
+            sample_idx, [](size_t idx, const psd_t& psd) {
+                return idx < psd_first_sample(psd);
+            });
+        if (it == psi.psds.begin()) {
+            return psi.psds.size();
+        }
+        --it;
+        if (sample_idx >= psd_first_sample(*it) + size_t(it->data_count)) {
+            return psi.psds.size();
+        }
+        return size_t(it - psi.psds.begin());
+    }
+
+    class psd_position_t {
+        public:
+        // Index into psi.psds
+        size_t psd;
+        // Byte offset of the sample record in the .psd file
+        size_t offset;
+    };
+
+    // Return the position of the record of the given sample, psd is
+    // psi.psds.size() if no psd holds it
+    inline psd_position_t psd_position(const psi_t& psi, size_t sample_idx)
+    {
+        auto position = psd_position_t{ psd_index(psi, sample_idx), 0 };
+        if (position.psd < psi.psds.size()) {
+            position.offset =
+                (sample_idx - psd_first_sample(psi.psds[ position.psd ])) *
+                sample_size(psi);
+        }
+        return position;
+    }
+
+    class sample_range_t {
+        public:
+        size_t first;
+        size_t count;
+    };
+
+    // Return the samples with a time in [begin, end] as done by load_samples
+    inline sample_range_t sample_range(const psi_t& psi,
+        std::chrono::nanoseconds begin, std::chrono::nanoseconds end)
+    {
+        auto range = sample_range_t{ 0, 0 };
+        const auto interval = psi.sampling_interval().count();
+        const auto total = psd_sample_count(psi);
+        if (total == 0 || end.count() < 0 || end < begin) {
+            return range;
+        }
+        if (begin.count() > 0) {
+            range.first = size_t((begin.count() + interval - 1) / interval);
+        }
+        auto last = std::min(size_t(end.count() / interval), total - 1);
+        if (range.first <= last) {
+            range.count = last - range.first + 1;
+        }
+        return range;
+    }
+
+    // Call read(psd, first, count) for the samples of range held by each
+    // psd in order, where first is relative to the beginning of the psd.
+    // read returns the number of samples it got, less than count for a
+    // truncated .psd file. The walk stops there or at the first gap in the
+    // psds. Returns the end of the samples of range read without a gap.
+    template < typename Reader >
+    inline size_t for_each_psd_segment(
+        const psi_t& psi, const sample_range_t& range, Reader&& read)
+    {
+        const auto range_end = range.first + range.count;
+        auto covered = range.first;
+        for (auto i = psd_index(psi, range.first); i < psi.psds.size(); ++i) {
+            const auto& psd = psi.psds[ i ];
+            const auto psd_begin = psd_first_sample(psd);
+            if (psd_begin >= range_end || psd_begin > covered) {
+                break;
+            }
+            const auto first = std::max(psd_begin, range.first);
+            const auto last =
+                std::min(psd_begin + size_t(psd.data_count), range_end);
+            const size_t n = read(psd, first - psd_begin, last - first);
+            covered = std::max(covered, first + n);
+            if (n < last - first) {
+                // Truncated psd file
+                break;
+            }
+        }
+        return covered;
+    }
+}
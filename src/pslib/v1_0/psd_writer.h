@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/load_psi.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/save_psi.h"
+#include "pslib/v1_0/write_psd.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Incremental writer for a recording. Samples are appended in batches to
+    // the current .psd file, a new .psd file is started whenever the current
+    // one is full and close() writes the matching .psi file.
+    // An existing recording can be continued as well, in which case only the
+    // appended samples and the .psi file are written.
+    class psd_writer {
+        private:
+        psi_t m_psi;
+        std::string m_directory;
+        std::string m_base_name;
+        size_t m_capacity;
+        std::ofstream m_psd_file;
+        std::vector< char > m_buffer;
+        bool m_closed;
+        // Continue the last existing psd before starting a new one
+        bool m_reopen;
+
+        public:
+        // The sampling rate, checksum and probes are taken from psi, its
+        // sampling count and psds are determined while writing.
+        // A psd_capacity of 0 fills every .psd file as far as possible,
+        // otherwise a new .psd file is started after psd_capacity samples.
+        inline psd_writer(const psi_t& psi, const std::string& directory,
+            const std::string& base_name, size_t psd_capacity = 0)
+            : m_psi{ psi }
+            , m_directory{ directory }
+            , m_base_name{ base_name }
+            , m_capacity{ pslib::v1_0::psd_sample_capacity(psi) }
+            , m_closed{ false }
+            , m_reopen{ false }
+        {
+            if (psd_capacity > 0) {
+                m_capacity = std::min(m_capacity, psd_capacity);
+            }
+            m_psi.filename = directory + "/" + base_name + ".psi";
+            m_psi.sampling_count = 0;
+            m_psi.psds.clear();
+        }
+
+        // Append to the recording of the .psi file psi_filename. Writing
+        // continues at the end of the last .psd file, the existing samples
+        // are neither read nor rewritten.
+        inline psd_writer(
+            const std::string& psi_filename, size_t psd_capacity = 0)
+            : m_psi{ pslib::v1_0::load_psi(psi_filename) }
+            , m_directory{ boost::filesystem::path(psi_filename)
+                               .parent_path()
+                               .string() }
+            , m_base_name{ boost::filesystem::path(psi_filename)
+                               .stem()
+                               .string() }
+            , m_capacity{ pslib::v1_0::psd_sample_capacity(m_psi) }
+            , m_closed{ false }
+            , m_reopen{ true }
+        {
+            if (psd_capacity > 0) {
+                m_capacity = std::min(m_capacity, psd_capacity);
+            }
+            if (m_directory.empty()) {
+                m_directory = ".";
+            }
+        }
+
+        psd_writer(const psd_writer&) = delete;
+        psd_writer& operator=(const psd_writer&) = delete;
+
+        inline ~psd_writer()
+        {
+            if (!m_closed) {
+                try {
+                    this->close();
+                }
+                catch (...) {
+                }
+            }
+        }
+
+        inline const psi_t& psi() const
+        {
+            return m_psi;
+        }
+
+        // Append count samples where values holds probe_count data streams
+        // and events holds probe_count + 1 events per sample
+        inline void write(
+            const data_stream_t* values, const event_t* events, size_t count)
+        {
+            if (m_closed) {
+                throw std::runtime_error(
+                    "Unable to write to closed " + m_psi.filename);
+            }
+            const size_t probe_count = m_psi.probes.size();
+            while (count > 0) {
+                auto& psd = this->current_psd();
+                const auto n =
+                    std::min(count, m_capacity - size_t(psd.data_count));
+                if (!pslib::v1_0::write_samples(m_psd_file, values, events, n,
+                        probe_count, m_buffer)) {
+                    throw std::runtime_error("Unable to write " +
+                                             pslib::v1_0::psd_filename(
+                                                 m_psi, psd));
+                }
+                psd.data_count += int64_t(n);
+                psd.event_count += int64_t(pslib::v1_0::count_events(
+                    events, n * (probe_count + 1)));
+                m_psi.sampling_count += n;
+
+                values += n * probe_count;
+                events += n * (probe_count + 1);
+                count -= n;
+            }
+        }
+
+        inline void write(const samples_t& samples)
+        {
+            this->write(
+                samples.values.data(), samples.events.data(), samples.size());
+        }
+
+        // Flush all written samples to the operating system
+        inline void flush()
+        {
+            if (!m_psd_file.is_open()) {
+                return;
+            }
+            m_psd_file.flush();
+            if (m_psd_file.fail()) {
+                throw std::runtime_error("Unable to write " +
+                                         pslib::v1_0::psd_filename(
+                                             m_psi, m_psi.psds.back()));
+            }
+        }
+
+        // Flush all written samples, wait until they reached the disk and
+        // (atomically) write a .psi file covering them, so the recording can
+        // be loaded up to here even if close() is never reached. Full .psd
+        // files were already synced when they were closed.
+        inline void sync()
+        {
+            if (m_closed) {
+                return;
+            }
+            this->flush();
+            if (m_psd_file.is_open()) {
+                pslib::v1_0::sync_file(
+                    pslib::v1_0::psd_filename(m_psi, m_psi.psds.back()));
+            }
+            pslib::v1_0::replace_psi(m_psi, m_directory, m_base_name);
+        }
+
+        // Finish the last .psd file and (atomically) write the .psi file
+        inline const psi_t& close()
+        {
+            if (m_closed) {
+                return m_psi;
+            }
+            m_closed = true;
+            this->close_psd();
+            pslib::v1_0::replace_psi(m_psi, m_directory, m_base_name);
+            return m_psi;
+        }
+
+        private:
+        // Return the psd to write to, starting a new one if needed
+        inline psd_t& current_psd()
+        {
+            if (m_psd_file.is_open() &&
+                size_t(m_psi.psds.back().data_count) < m_capacity) {
+                return m_psi.psds.back();
+            }
+            if (m_reopen) {
+                m_reopen = false;
+                if (!m_psi.psds.empty() &&
+                    size_t(m_psi.psds.back().data_count) < m_capacity) {
+                    return this->reopen_psd();
+                }
+            }
+            this->close_psd();
+
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = int64_t(m_psi.psds.size() + 1);
+                psd.offset = m_psi.sampling_count > 0
+                                 ? int64_t(m_psi.sampling_count + 1)
+                                 : 0;
+                psd.data_count = 0;
+                psd.event_count = 0;
+            }
+            m_psi.psds.push_back(psd);
+
+            auto psd_filename = pslib::v1_0::psd_filename(m_psi, psd);
+            m_psd_file.open(
+                psd_filename, std::ios::binary | std::ios::trunc);
+            if (!m_psd_file.is_open()) {
+                throw std::runtime_error("Unable to open " + psd_filename);
+            }
+            return m_psi.psds.back();
+        }
+
+        // Continue writing after the last sample of the last psd
+        inline psd_t& reopen_psd()
+        {
+            auto& psd = m_psi.psds.back();
+            auto psd_filename = pslib::v1_0::psd_filename(m_psi, psd);
+            m_psd_file.open(
+                psd_filename, std::ios::binary | std::ios::in | std::ios::out);
+            if (!m_psd_file.is_open()) {
+                throw std::runtime_error("Unable to open " + psd_filename);
+            }
+            m_psd_file.seekp(std::streamoff(size_t(psd.data_count) *
+                                            pslib::v1_0::sample_size(m_psi)));
+            if (!m_psd_file) {
+                throw std::runtime_error("Unable to seek in " + psd_filename);
+            }
+            return psd;
+        }
+
+        inline void close_psd()
+        {
+            if (!m_psd_file.is_open()) {
+                return;
+            }
+            auto psd_filename =
+                pslib::v1_0::psd_filename(m_psi, m_psi.psds.back());
+            // Buffered samples which can't be written must not be padded
+            // with zeros below
+            m_psd_file.flush();
+            m_psd_file.close();
+            if (m_psd_file.fail()) {
+                throw std::runtime_error("Unable to write " + psd_filename);
+            }
+
+            // Pad every psd file to 1 GiB
+            if (boost::filesystem::file_size(psd_filename) < psd_file_size) {
+                boost::filesystem::resize_file(psd_filename, psd_file_size);
+            }
+            // A later sync() only covers the current psd
+            pslib::v1_0::sync_file(psd_filename);
+        }
+    };
+}
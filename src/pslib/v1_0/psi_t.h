@@ -38,6 +38,9 @@ namespace pslib::v1_0 {
         std::string filename;
 
         uint32_t checksum;
+        // Number of times samples were modified in place (see
+        // update_samples), sidecar files built before are stale
+        uint64_t revision;
         uint64_t sampling_rate; // (in Hz)
         uint64_t sampling_count;
         std::vector< pslib::v1_0::probe_t > probes;
@@ -62,6 +65,9 @@ namespace pslib::v1_0 {
         if (lhs.checksum != rhs.checksum) {
             return false;
         }
+        if (lhs.revision != rhs.revision) {
+            return false;
+        }
         if (lhs.sampling_rate != rhs.sampling_rate) {
             return false;
         }
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/load_psx.h"
+#include "pslib/v1_0/load_samples.h"
+#include "pslib/v1_0/probe_statistics.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/psx_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Return the statistics of each probe over the samples in [begin, end]
+    // (same as probe_statistics). Whole blocks are taken from the pyramid
+    // with O(log n) lookups, only the samples of the partial blocks at both
+    // edges are read from the .psd files.
+    inline std::vector< probe_statistics_t > psx_statistics(const psx_t& psx,
+        const shared_psi_t& shared_psi,
+        std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+        NAN_POLICY policy = NAN_POLICY::SKIP)
+    {
+        const psi_t& psi = *shared_psi;
+        if (pslib::v1_0::psx_is_stale(psx, psi)) {
+            throw std::runtime_error("Stale PSX for " + psi.filename);
+        }
+        if (end <= std::chrono::nanoseconds(-1)) {
+            end = psi.length();
+        }
+        const size_t probe_count = psi.probes.size();
+        std::vector< probe_statistics_t > summaries(probe_count);
+
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        const auto range_end = range.first + range.count;
+        const auto block_size = size_t(psx.block_size);
+
+        // Whole level 0 blocks within the range, the last (partial) block of
+        // the recording counts as whole if the range reaches its end
+        auto block_first = (range.first + block_size - 1) / block_size;
+        auto block_last = range_end / block_size;
+        if (range_end == psx.data_count) {
+            block_last = psx.block_count(0);
+        }
+        if (block_first >= block_last) {
+            block_first = block_last = 0;
+        }
+
+        auto add_samples = [&](size_t first, size_t last) {
+            if (first >= last) {
+                return;
+            }
+            const auto interval = psi.sampling_interval();
+            auto samples = pslib::v1_0::load_samples(
+                shared_psi, first * interval, (last - 1) * interval);
+            pslib::v1_0::add_probe_statistics(
+                samples.values.data(), samples.size(), summaries);
+        };
+
+        if (block_first == block_last) {
+            add_samples(range.first, range_end);
+        }
+        else {
+            add_samples(range.first, block_first * block_size);
+            add_samples(
+                std::min(block_last * block_size, range_end), range_end);
+
+            // Cover [block_first, block_last) with the fewest pyramid blocks
+            auto lo = block_first;
+            auto hi = block_last;
+            for (size_t level = 0; lo < hi && level < psx.levels.size();
+                 ++level) {
+                if (lo % 2 == 1) {
+                    for (size_t p = 0; p < probe_count; ++p) {
+                        summaries[ p ].add(psx.summary(level, lo, p));
+                    }
+                    ++lo;
+                }
+                if (hi % 2 == 1) {
+                    --hi;
+                    for (size_t p = 0; p < probe_count; ++p) {
+                        summaries[ p ].add(psx.summary(level, hi, p));
+                    }
+                }
+                lo /= 2;
+                hi /= 2;
+            }
+            if (lo < hi) {
+                // The pyramid ends before a single block covers the rest
+                throw std::runtime_error("Incomplete PSX for " + psi.filename);
+            }
+        }
+        for (auto& s : summaries) {
+            s.apply(policy);
+        }
+        return summaries;
+    }
+}
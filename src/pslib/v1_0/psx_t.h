@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Multi-resolution summary pyramid of a recording as stored in the .psx
+    // sidecar file of a .psi file.
+    // Level 0 summarises blocks of block_size samples, every further level
+    // summarises two blocks of the level below.
+    class psx_t {
+        public:
+        // Values of the psi this pyramid was built from, used to detect a
+        // stale pyramid
+        uint32_t checksum;
+        uint64_t sampling_count;
+        uint64_t data_count;
+        uint64_t probe_count;
+        uint64_t revision;
+
+        // Number of samples summarised by a level 0 block (a power of two)
+        uint64_t block_size;
+        // levels[ l ][ b * probe_count + p ] holds the statistics of probe p
+        // in block b of level l, NaN values are counted but skipped
+        std::vector< std::vector< probe_statistics_t > > levels;
+
+        public:
+        // Number of blocks on the given level
+        inline size_t block_count(size_t level) const
+        {
+            return this->levels[ level ].size() / size_t(this->probe_count);
+        }
+
+        inline const probe_statistics_t& summary(
+            size_t level, size_t block, size_t probe) const
+        {
+            return this->levels[ level ][ block * this->probe_count + probe ];
+        }
+    };
+}
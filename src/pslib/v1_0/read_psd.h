@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Default size of the blocks read at once from a .psd file
+    constexpr size_t psd_read_block_size = 4ul * 1024ul * 1024ul;
+
+    // Scatter count sample records into the given values and events
+    inline void decode_samples(const char* records, size_t count,
+        size_t probe_count, data_stream_t* values, event_t* events)
+    {
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t events_size = sizeof(event_t) * (probe_count + 1);
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(values, records, values_size);
+            std::memcpy(events, records + values_size, events_size);
+            records += values_size + events_size;
+            values += probe_count;
+            events += probe_count + 1;
+        }
+    }
+
+    // Random access iterator over the fields of type T in consecutive
+    // records, field_count of them at the same offset in every record. The
+    // records are only 2 byte aligned, so every field is copied out with
+    // memcpy when dereferenced.
+    template < typename T > class record_field_iterator {
+        private:
+        const char* m_record;
+        size_t m_field;
+        size_t m_record_size;
+        size_t m_field_count;
+
+        public:
+        typedef record_field_iterator self_type;
+        typedef T value_type;
+        typedef T reference;
+        typedef const T* pointer;
+        typedef ptrdiff_t difference_type;
+        typedef std::random_access_iterator_tag iterator_category;
+
+        public:
+        // Iterator to field field of the record at records (+ offset)
+        inline record_field_iterator(const char* records, size_t record_size,
+            size_t field_count, size_t field = 0)
+            : m_record{ records }
+            , m_field{ field }
+            , m_record_size{ record_size }
+            , m_field_count{ field_count }
+        {
+            *this += 0;
+        }
+
+        inline reference operator*() const
+        {
+            T value;
+            std::memcpy(&value, m_record + sizeof(T) * m_field, sizeof(T));
+            return value;
+        }
+        inline reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        inline self_type& operator+=(difference_type n)
+        {
+            const auto field = difference_type(m_field) + n;
+            auto records = field / difference_type(m_field_count);
+            if (field % difference_type(m_field_count) < 0) {
+                --records;
+            }
+            m_record += records * difference_type(m_record_size);
+            m_field = size_t(field - records * difference_type(m_field_count));
+            return *this;
+        }
+        inline self_type& operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+        inline self_type& operator++()
+        {
+            if (++m_field == m_field_count) {
+                m_field = 0;
+                m_record += m_record_size;
+            }
+            return *this;
+        }
+        inline self_type operator++(int)
+        {
+            self_type i = *this;
+            ++*this;
+            return i;
+        }
+        inline self_type& operator--()
+        {
+            return *this -= 1;
+        }
+        inline self_type operator--(int)
+        {
+            self_type i = *this;
+            --*this;
+            return i;
+        }
+        inline self_type operator+(difference_type n) const
+        {
+            self_type i = *this;
+            return i += n;
+        }
+        inline self_type operator-(difference_type n) const
+        {
+            self_type i = *this;
+            return i -= n;
+        }
+        inline difference_type operator-(const self_type& rhs) const
+        {
+            return (m_record - rhs.m_record) /
+                       difference_type(m_record_size) *
+                       difference_type(m_field_count) +
+                   difference_type(m_field) - difference_type(rhs.m_field);
+        }
+
+        inline bool operator==(const self_type& rhs) const
+        {
+            return m_record == rhs.m_record && m_field == rhs.m_field;
+        }
+        inline bool operator!=(const self_type& rhs) const
+        {
+            return !(*this == rhs);
+        }
+        inline bool operator<(const self_type& rhs) const
+        {
+            return *this - rhs < 0;
+        }
+        inline bool operator>(const self_type& rhs) const
+        {
+            return rhs < *this;
+        }
+        inline bool operator<=(const self_type& rhs) const
+        {
+            return !(rhs < *this);
+        }
+        inline bool operator>=(const self_type& rhs) const
+        {
+            return !(*this < rhs);
+        }
+    };
+
+    // Append count sample records to values and events. The records are
+    // copy constructed directly into the (reserved) storage of the
+    // containers, which saves zero filling it before the copy.
+    template < typename Values, typename Events >
+    inline void append_samples(const char* records, size_t count,
+        size_t probe_count, Values& values, Events& events)
+    {
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t record_size =
+            values_size + sizeof(event_t) * (probe_count + 1);
+        if (probe_count > 0) {
+            auto first = record_field_iterator< data_stream_t >(
+                records, record_size, probe_count);
+            values.insert(values.end(), first,
+                first + std::ptrdiff_t(count * probe_count));
+        }
+        auto first = record_field_iterator< event_t >(
+            records + values_size, record_size, probe_count + 1);
+        events.insert(events.end(), first,
+            first + std::ptrdiff_t(count * (probe_count + 1)));
+    }
+
+    // Read count sample records beginning with the sample first (relative to
+    // the beginning of the psd) from the .psd file of psd and pass them to
+    // decode(const char* records, size_t n) in consecutive chunks. The file
+    // is read in blocks of (roughly) block_size bytes using buffer, which is
+    // resized as needed and may be reused between calls.
+    // Returns the number of samples actually read, which is less than count
+    // for a truncated .psd file. A missing .psd file throws, as it does for
+    // sample_reader.
+    template < typename Decoder >
+    inline size_t read_psd_records(const psi_t& psi, const psd_t& psd,
+        size_t first, size_t count, std::vector< char >& buffer,
+        Decoder&& decode, size_t block_size = psd_read_block_size)
+    {
+        const size_t record_size = pslib::v1_0::sample_size(psi);
+        // Don't allocate a whole block for a few samples
+        const size_t block_count =
+            std::max(std::min(block_size / record_size, count), size_t(1));
+        buffer.resize(block_count * record_size);
+
+        auto psd_filename = pslib::v1_0::psd_filename(psi, psd);
+        // Open psd file to read data
+        std::ifstream psd_ifstream(psd_filename, std::ios::binary);
+        if (!psd_ifstream.is_open()) {
+            throw std::runtime_error("Unable to open " + psd_filename);
+        }
+        psd_ifstream.seekg(std::streamoff(first * record_size));
+
+        size_t read = 0;
+        while (psd_ifstream.good() && read < count) {
+            const auto n = std::min(block_count, count - read);
+            psd_ifstream.read(buffer.data(), std::streamsize(n * record_size));
+            const auto n_read = size_t(psd_ifstream.gcount()) / record_size;
+            decode(static_cast< const char* >(buffer.data()), n_read);
+            read += n_read;
+        }
+        return read;
+    }
+
+    // Same as read_psd_records but scatters the records into the given
+    // values and events
+    inline size_t read_psd(const psi_t& psi, const psd_t& psd, size_t first,
+        size_t count, data_stream_t* values, event_t* events,
+        std::vector< char >& buffer,
+        size_t block_size = psd_read_block_size)
+    {
+        const size_t probe_count = psi.probes.size();
+        return read_psd_records(psi, psd, first, count, buffer,
+            [&](const char* records, size_t n) {
+                pslib::v1_0::decode_samples(
+                    records, n, probe_count, values, events);
+                values += n * probe_count;
+                events += n * (probe_count + 1);
+            },
+            block_size);
+    }
+
+    inline size_t read_psd(const psi_t& psi, const psd_t& psd, size_t first,
+        size_t count, data_stream_t* values, event_t* events)
+    {
+        std::vector< char > buffer;
+        return read_psd(psi, psd, first, count, values, events, buffer);
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Call f(t) for every t in [0, thread_count) on its own thread (t = 0 on
+    // the calling one), wait for all of them and rethrow the first exception
+    // thrown by any call
+    template < typename F >
+    inline void run_workers(size_t thread_count, const F& f)
+    {
+        std::exception_ptr error;
+        std::mutex mutex;
+        auto worker = [&](size_t t) {
+            try {
+                f(t);
+            }
+            catch (...) {
+                std::lock_guard< std::mutex > lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector< std::thread > workers;
+        workers.reserve(thread_count);
+        for (size_t t = 1; t < thread_count; ++t) {
+            workers.emplace_back(worker, t);
+        }
+        worker(0);
+        for (auto& w : workers) {
+            w.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Polymorphic allocator of the sample storage (see samples_t). Unlike
+    // std::pmr::polymorphic_allocator it default-initializes elements
+    // which are constructed without arguments, so resize() of a vector of
+    // data streams or events only sizes the storage without zero filling
+    // it. Loaders can then size the storage up front and let every worker
+    // touch (and fault in) the pages of its own slice first.
+    template < typename T >
+    class sample_allocator : public std::pmr::polymorphic_allocator< T > {
+        public:
+        inline sample_allocator() noexcept = default;
+
+        inline sample_allocator(std::pmr::memory_resource* resource) noexcept
+            : std::pmr::polymorphic_allocator< T >(resource)
+        {
+        }
+
+        template < typename U >
+        inline sample_allocator(const sample_allocator< U >& other) noexcept
+            : std::pmr::polymorphic_allocator< T >(other.resource())
+        {
+        }
+
+        template < typename U > inline void construct(U* p)
+        {
+            ::new (static_cast< void* >(p)) U;
+        }
+
+        template < typename U, typename... Args >
+        inline void construct(U* p, Args&&... args)
+        {
+            std::pmr::polymorphic_allocator< T >::construct(
+                p, std::forward< Args >(args)...);
+        }
+
+        // Copies of containers use the default resource like the ones
+        // using std::pmr::polymorphic_allocator
+        inline sample_allocator select_on_container_copy_construction() const
+        {
+            return sample_allocator();
+        }
+    };
+
+    // Vector of data streams or events using a sample_allocator
+    template < typename T >
+    using sample_vector = std::vector< T, sample_allocator< T > >;
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+// Posix
+#include <sys/mman.h>
+
+namespace pslib::v1_0 {
+    enum class HUGE_PAGES {
+        // Regular pages only
+        NONE,
+        // Ask the kernel to back the blocks with transparent huge pages
+        TRANSPARENT,
+        // Allocate the blocks from the reserved huge pages (MAP_HUGETLB) and
+        // fall back to transparent huge pages if none are available
+        EXPLICIT,
+    };
+
+    // Memory resource for samples_t which hands out memory from a few large
+    // blocks mapped from the operating system. Memory isn't returned on
+    // deallocation but all at once by reset(), which keeps the (already
+    // faulted in) blocks for the following allocations. So repeated loads
+    // into the same arena neither fragment the heap nor page fault again:
+    //
+    //     auto arena = pslib::v1_0::sample_arena();
+    //     for (auto& window : windows) {
+    //         auto samples = pslib::v1_0::load_samples(
+    //             psi, window.begin, window.end, &arena);
+    //         // [..] Process the samples, they must not outlive the reset
+    //         arena.reset();
+    //     }
+    //
+    // The arena is not thread-safe.
+    class sample_arena : public std::pmr::memory_resource {
+        public:
+        // Size of a huge page (and granularity of the blocks)
+        static constexpr size_t huge_page_size = 2ul * 1024ul * 1024ul;
+        // Default minimum size of a block
+        static constexpr size_t default_block_size = 64ul * 1024ul * 1024ul;
+
+        private:
+        class block_t {
+            public:
+            char* data;
+            size_t size;
+            size_t used;
+            bool huge_pages;
+        };
+
+        HUGE_PAGES m_huge_pages;
+        size_t m_block_size;
+        std::vector< block_t > m_blocks;
+        // Index of the block allocations are taken from
+        size_t m_current;
+
+        public:
+        inline sample_arena(HUGE_PAGES huge_pages = HUGE_PAGES::TRANSPARENT,
+            size_t block_size = default_block_size)
+            : m_huge_pages{ huge_pages }
+            , m_block_size{ round_up(std::max(block_size, size_t(1))) }
+            , m_current{ 0 }
+        {
+        }
+
+        sample_arena(const sample_arena&) = delete;
+        sample_arena& operator=(const sample_arena&) = delete;
+
+        inline ~sample_arena() override
+        {
+            for (auto& block : m_blocks) {
+                ::munmap(block.data, block.size);
+            }
+        }
+
+        // Make all memory available again. Everything allocated before must
+        // not be used anymore.
+        inline void reset()
+        {
+            for (auto& block : m_blocks) {
+                block.used = 0;
+            }
+            m_current = 0;
+        }
+
+        // Number of bytes mapped from the operating system
+        inline size_t capacity() const
+        {
+            size_t capacity = 0;
+            for (const auto& block : m_blocks) {
+                capacity += block.size;
+            }
+            return capacity;
+        }
+
+        // Number of bytes handed out since the last reset()
+        inline size_t used() const
+        {
+            size_t used = 0;
+            for (const auto& block : m_blocks) {
+                used += block.used;
+            }
+            return used;
+        }
+
+        // Number of blocks backed by explicit huge pages (MAP_HUGETLB)
+        inline size_t huge_page_blocks() const
+        {
+            return size_t(std::count_if(m_blocks.begin(), m_blocks.end(),
+                [](const block_t& block) { return block.huge_pages; }));
+        }
+
+        private:
+        static inline size_t round_up(size_t size)
+        {
+            return (size + huge_page_size - 1) / huge_page_size *
+                   huge_page_size;
+        }
+
+        inline void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            for (; m_current < m_blocks.size(); ++m_current) {
+                auto& block = m_blocks[ m_current ];
+                const size_t offset =
+                    (block.used + alignment - 1) / alignment * alignment;
+                if (offset + bytes <= block.size) {
+                    block.used = offset + bytes;
+                    return block.data + offset;
+                }
+            }
+
+            // Allocations are page aligned at the beginning of a block
+            auto block =
+                this->map_block(std::max(round_up(bytes), m_block_size));
+            block.used = bytes;
+            m_blocks.push_back(block);
+            m_current = m_blocks.size() - 1;
+            return block.data;
+        }
+
+        inline void do_deallocate(void*, size_t, size_t) override
+        {
+            // Memory is only released by reset() and the destructor
+        }
+
+        inline bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        inline block_t map_block(size_t size)
+        {
+            auto block = block_t{ nullptr, size, 0, false };
+            void* data = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+            if (m_huge_pages == HUGE_PAGES::EXPLICIT) {
+                data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                block.huge_pages = data != MAP_FAILED;
+            }
+#endif
+            if (data == MAP_FAILED) {
+                data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            }
+            if (data == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+#if defined(MADV_HUGEPAGE)
+            if (!block.huge_pages && m_huge_pages != HUGE_PAGES::NONE) {
+                // Only a hint, so failures are ignored
+                ::madvise(data, size, MADV_HUGEPAGE);
+            }
+#endif
+            block.data = static_cast< char* >(data);
+            return block;
+        }
+    };
+}
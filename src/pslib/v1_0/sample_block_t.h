@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/indexed_iterator.h"
+#include "pslib/v1_0/sample_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // A block of consecutive samples as handed out by the sample readers
+    class sample_block_t {
+        public:
+        // Random access iterator over the samples which yields a sample_t
+        // per sample
+        typedef indexed_iterator< sample_block_t, sample_t > sample_iterator;
+
+        public:
+        size_t probe_count;
+        std::chrono::nanoseconds sampling_interval;
+        // Sampling interval in seconds, not truncated to whole nano seconds
+        std::chrono::duration< double > exact_interval;
+        // Index of the first sample of this block within the recording
+        size_t first;
+        std::vector< data_stream_t > values;
+        std::vector< event_t > events;
+
+        public:
+        inline size_t size() const
+        {
+            return this->probe_count > 0
+                       ? this->values.size() / this->probe_count
+                       : 0;
+        }
+
+        inline std::chrono::nanoseconds begin_time() const
+        {
+            return this->first * this->sampling_interval;
+        }
+
+        inline sample_t at(size_t idx) const
+        {
+            return sample_t(this->values.data() + idx * this->probe_count,
+                this->probe_count,
+                this->events.data() + idx * (this->probe_count + 1),
+                this->probe_count + 1,
+                (this->first + idx) * this->sampling_interval);
+        }
+
+        inline sample_t operator[](size_t idx) const
+        {
+            return this->at(idx);
+        }
+
+        inline sample_iterator begin() const
+        {
+            return sample_iterator(0, this);
+        }
+
+        inline sample_iterator end() const
+        {
+            return sample_iterator(this->size(), this);
+        }
+    };
+}
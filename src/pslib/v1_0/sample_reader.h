@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/read_psd.h"
+#include "pslib/v1_0/sample_block_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Default number of samples per block of a sample_reader
+    constexpr size_t sample_reader_block_size = 64ul * 1024ul;
+
+    // Pull based reader which walks the .psd files of a time range in order
+    // and hands them out in blocks of a fixed number of samples. Like
+    // load_samples it stops at a truncated .psd file and throws if a .psd
+    // file is missing.
+    class sample_reader {
+        private:
+        shared_psi_t m_psi;
+        sample_range_t m_range;
+        size_t m_block_size;
+        // Index of the next sample to read within the recording
+        size_t m_next;
+        // Index into m_psi->psds of the currently opened psd
+        size_t m_psd_idx;
+        std::ifstream m_psd_ifstream;
+        std::vector< char > m_buffer;
+        std::vector< sample_block_t > m_blocks;
+        size_t m_block_idx;
+
+        public:
+        // Read the samples of [begin, end] (same as load_samples) in blocks
+        // of block_size samples. The reader keeps at most max_blocks blocks
+        // handed out by next() in memory.
+        inline sample_reader(const shared_psi_t& psi,
+            std::chrono::nanoseconds begin = std::chrono::nanoseconds(0),
+            std::chrono::nanoseconds end = std::chrono::nanoseconds(-1),
+            size_t block_size = sample_reader_block_size,
+            size_t max_blocks = 1)
+            : m_psi{ psi }
+            , m_range{ pslib::v1_0::sample_range(*psi, begin,
+                  end <= std::chrono::nanoseconds(-1) ? psi->length() : end) }
+            , m_block_size{ std::max(block_size, size_t(1)) }
+            , m_next{ m_range.first }
+            , m_psd_idx{ psi->psds.size() }
+            , m_blocks(std::max(max_blocks, size_t(1)))
+            , m_block_idx{ 0 }
+        {
+        }
+
+        inline const psi_t& psi() const
+        {
+            return *m_psi;
+        }
+
+        // Number of samples not yet read
+        inline size_t remaining() const
+        {
+            return m_range.first + m_range.count - m_next;
+        }
+
+        // Fill block with the next (up to) block_size samples, reusing its
+        // storage. Returns false if all samples were read.
+        inline bool read(sample_block_t& block)
+        {
+            const size_t probe_count = m_psi.probe_count();
+            const size_t record_size = m_psi.record_size();
+            const size_t count = std::min(m_block_size, this->remaining());
+
+            block.probe_count = probe_count;
+            block.sampling_interval = m_psi.interval();
+            block.exact_interval = m_psi.exact_interval();
+            block.first = m_next;
+            block.values.resize(count * probe_count);
+            block.events.resize(count * (probe_count + 1));
+
+            size_t read = 0;
+            while (read < count) {
+                if (!this->open_psd()) {
+                    // Gap in the psds, stop reading as for a truncated psd
+                    m_range.count = m_next - m_range.first;
+                    break;
+                }
+                const auto& psd_range = m_psi.psd_ranges()[ m_psd_idx ];
+                const auto psd_end =
+                    psd_range.first_sample + psd_range.sample_count;
+                const auto n = std::min({ count - read, psd_end - m_next,
+                    m_buffer.size() / record_size });
+                m_psd_ifstream.read(
+                    m_buffer.data(), std::streamsize(n * record_size));
+                const auto n_read =
+                    size_t(m_psd_ifstream.gcount()) / record_size;
+                pslib::v1_0::decode_samples(m_buffer.data(), n_read,
+                    probe_count, block.values.data() + read * probe_count,
+                    block.events.data() + read * (probe_count + 1));
+                read += n_read;
+                m_next += n_read;
+                if (n_read < n) {
+                    // Truncated psd file, stop reading
+                    m_range.count = m_next - m_range.first;
+                    break;
+                }
+            }
+            block.values.resize(read * probe_count);
+            block.events.resize(read * (probe_count + 1));
+            return read > 0;
+        }
+
+        // Return the next block or nullptr if all samples were read.
+        // The returned block stays valid for the next max_blocks - 1 calls.
+        inline const sample_block_t* next()
+        {
+            auto& block = m_blocks[ m_block_idx ];
+            m_block_idx = (m_block_idx + 1) % m_blocks.size();
+            if (!this->read(block)) {
+                return nullptr;
+            }
+            return &block;
+        }
+
+        private:
+        // Make sure the psd holding m_next is opened and positioned
+        inline bool open_psd()
+        {
+            if (m_psd_idx < m_psi->psds.size()) {
+                const auto& psd_range = m_psi.psd_ranges()[ m_psd_idx ];
+                if (m_next < psd_range.first_sample + psd_range.sample_count) {
+                    return true;
+                }
+            }
+            m_psd_idx = pslib::v1_0::psd_index(*m_psi, m_next);
+            if (m_psd_idx >= m_psi->psds.size()) {
+                return false;
+            }
+            const auto& psd = m_psi->psds[ m_psd_idx ];
+            const size_t record_size = m_psi.record_size();
+            m_psd_ifstream.close();
+            m_psd_ifstream.clear();
+            const auto psd_filename = pslib::v1_0::psd_filename(*m_psi, psd);
+            m_psd_ifstream.open(psd_filename, std::ios::binary);
+            if (!m_psd_ifstream.is_open()) {
+                throw std::runtime_error("Unable to open " + psd_filename);
+            }
+            m_psd_ifstream.seekg(std::streamoff(
+                (m_next - m_psi.psd_ranges()[ m_psd_idx ].first_sample) *
+                record_size));
+            if (m_buffer.empty()) {
+                // No read is larger than a block or the rest of the range
+                m_buffer.resize(
+                    std::max(std::min({ psd_read_block_size / record_size,
+                                 m_block_size, this->remaining() }),
+                        size_t(1)) *
+                    record_size);
+            }
+            return true;
+        }
+    };
+}
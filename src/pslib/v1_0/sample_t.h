@@ -29,6 +29,7 @@
 #include "pslib/v1_0/data_stream_t.h"
 #include "pslib/v1_0/event_t.h"
 #include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_allocator.h"
 
 // StdLib
 #include <chrono>
@@ -36,9 +37,11 @@
 
 namespace pslib::v1_0 {
     class samples_t;
+    class sample_block_t;
 
     class sample_t {
         friend samples_t;
+        friend sample_block_t;
 
         public:
         std::chrono::nanoseconds time;
@@ -46,14 +49,25 @@ namespace pslib::v1_0 {
         boost::multi_array_ref< const pslib::v1_0::event_t, 1 > events;
 
         private:
-        sample_t(const psi_t& psi, const std::vector< data_stream_t >& val,
-            const std::vector< event_t >& ev, size_t sample_idx,
+        sample_t(const psi_t& psi, const sample_vector< data_stream_t >& val,
+            const sample_vector< event_t >& ev, size_t sample_idx,
             std::chrono::nanoseconds t)
+            : sample_t(val.empty()
+                           ? nullptr
+                           : val.data() + (psi.probes.size() * sample_idx),
+                  val.empty() ? 0 : psi.probes.size(),
+                  ev.empty()
+                      ? nullptr
+                      : ev.data() + ((psi.probes.size() + 1) * sample_idx),
+                  ev.empty() ? 0 : psi.probes.size() + 1, t)
+        {
+        }
+
+        sample_t(const data_stream_t* val, size_t value_count,
+            const event_t* ev, size_t event_count, std::chrono::nanoseconds t)
             : time{ t }
-            , values{ val.data() + (psi.probes.size() * sample_idx),
-                boost::extents[ int64_t(psi.probes.size()) ] }
-            , events{ ev.data() + ((psi.probes.size() + 1) * sample_idx),
-                boost::extents[ int64_t(psi.probes.size()) + 1 ] }
+            , values{ val, boost::extents[ int64_t(value_count) ] }
+            , events{ ev, boost::extents[ int64_t(event_count) ] }
         {
         }
     };
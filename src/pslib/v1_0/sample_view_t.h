@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/span_t.h"
+
+// StdLib
+#include <chrono>
+
+namespace pslib::v1_0 {
+    // Lightweight view on a single sample of a samples_t. Unlike sample_t it
+    // is just a few pointers and can be created for free while iterating.
+    // It is only valid as long as the samples_t it refers to isn't modified.
+    class sample_view_t {
+        public:
+        std::chrono::nanoseconds time;
+        // One data stream per probe
+        span_t< const data_stream_t > values;
+        // One event per probe followed by the global event
+        span_t< const event_t > events;
+    };
+
+    inline bool operator==(const sample_view_t& lhs, const sample_view_t& rhs)
+    {
+        return lhs.time == rhs.time && lhs.values == rhs.values &&
+               lhs.events == rhs.events;
+    }
+
+    inline bool operator!=(const sample_view_t& lhs, const sample_view_t& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
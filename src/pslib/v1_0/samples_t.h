@@ -25,111 +25,204 @@
 // Own
 #include "pslib/v1_0/data_stream_t.h"
 #include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/indexed_iterator.h"
 #include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_allocator.h"
 #include "pslib/v1_0/sample_t.h"
+#include "pslib/v1_0/sample_view_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/span_t.h"
 
 // StdLib
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace pslib::v1_0 {
 
     class samples_t {
         public:
-        class sample_iterator {
-            private:
-            size_t m_idx;
-            samples_t* m_samples;
+        // Random access iterator over the samples which yields a
+        // sample_view_t per sample
+        typedef indexed_iterator< samples_t, sample_view_t > sample_iterator;
 
-            public:
-            typedef sample_iterator self_type;
-            typedef sample_t value_type;
-            typedef sample_t reference;
-            typedef sample_t pointer;
-            typedef ptrdiff_t difference_type;
-            typedef std::forward_iterator_tag iterator_category;
+        // Consecutive samples of a samples_t
+        class slice_t {
+            private:
+            const samples_t* m_samples;
+            sample_iterator m_begin;
+            sample_iterator m_end;
 
             public:
-            inline sample_iterator(size_t idx, samples_t* samples)
-                : m_idx{ idx }
-                , m_samples{ samples }
+            inline slice_t(const samples_t* samples, sample_iterator begin,
+                sample_iterator end)
+                : m_samples{ samples }
+                , m_begin{ begin }
+                , m_end{ end }
             {
             }
 
-            inline self_type operator++()
-            {
-                self_type i = *this;
-                m_idx++;
-                return i;
-            }
-            inline self_type operator++(int junk)
+            // Psi of the samples the slice was cut from
+            inline const shared_psi_t& psi() const
             {
-                m_idx++;
-                return *this;
+                return m_samples->psi;
             }
-            inline reference operator*()
+
+            inline size_t size() const
             {
-                return m_samples->at(m_idx);
+                return size_t(m_end - m_begin);
             }
-            inline pointer operator->()
+
+            inline sample_view_t operator[](size_t idx) const
             {
-                return m_samples->at(m_idx);
+                return m_begin[ difference_type(idx) ];
             }
-            inline bool operator==(const self_type& rhs)
+
+            inline sample_iterator begin() const
             {
-                return m_idx == rhs.m_idx && m_samples == rhs.m_samples;
+                return m_begin;
             }
-            inline bool operator!=(const self_type& rhs)
+
+            inline sample_iterator end() const
             {
-                return !(*this == rhs);
+                return m_end;
             }
+
+            private:
+            typedef sample_iterator::difference_type difference_type;
         };
 
         public:
-        psi_t psi;
+        // Shared with all other samples of the same recording, use psi-> to
+        // access the psi_t
+        shared_psi_t psi;
         std::chrono::nanoseconds begin_time;
         std::chrono::nanoseconds end_time;
-        std::vector< data_stream_t > values;
-        std::vector< event_t > events;
+        // The storage of values and events is allocated from the memory
+        // resource given on construction, e.g. a sample_arena. Elements
+        // added by resize() are left uninitialized (see sample_allocator).
+        sample_vector< data_stream_t > values;
+        sample_vector< event_t > events;
 
         public:
+        inline samples_t(const shared_psi_t& p,
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end,
+            std::pmr::memory_resource* resource =
+                std::pmr::get_default_resource())
+            : psi{ p }
+            , begin_time{ begin }
+            , end_time{ end }
+            , values{ resource }
+            , events{ resource }
+        {
+            // [begin, end] holds up to one sample more than the quotient
+            const auto count = size_t((end - begin) / p.interval()) + 1;
+            this->values.reserve(count * p.probe_count());
+            this->events.reserve(count * (p.probe_count() + 1));
+        }
+
+        // Copies p into a new shared_psi_t
         inline samples_t(const psi_t& p, std::chrono::nanoseconds begin,
-            std::chrono::nanoseconds end)
+            std::chrono::nanoseconds end,
+            std::pmr::memory_resource* resource =
+                std::pmr::get_default_resource())
+            : samples_t(shared_psi_t(p), begin, end, resource)
         {
-            this->psi = p;
-            this->begin_time = begin;
-            this->end_time = end;
-            this->values.reserve(size_t((end - begin) / p.sampling_interval()) *
-                                 p.probes.size());
-            this->events.reserve(size_t((end - begin) / p.sampling_interval()) *
-                                 (p.probes.size() + 1));
         }
 
         inline size_t size() const
         {
-            return this->values.size() / this->psi.probes.size();
+            if (this->values.empty()) {
+                // Samples holding events only
+                return this->events.size() / (this->psi.probe_count() + 1);
+            }
+            return this->values.size() / this->psi.probe_count();
         }
 
         inline sample_t at(size_t idx) const
         {
-            auto idx_offset = this->begin_time.count() /
-                              this->psi.sampling_interval().count();
-            auto time =
-                (idx + size_t(idx_offset)) * this->psi.sampling_interval();
-            return sample_t(this->psi, this->values, this->events, idx, time);
+            auto time = (idx + this->first_index()) *
+                        this->psi.interval();
+            return sample_t(*this->psi, this->values, this->events, idx, time);
+        }
+
+        // Return a view on the sample idx, which (unlike at()) doesn't
+        // allocate or copy anything
+        inline sample_view_t view(size_t idx) const
+        {
+            const size_t probe_count = this->psi.probe_count();
+            auto view = sample_view_t();
+            {
+                view.time = (idx + this->first_index()) *
+                            this->psi.interval();
+                if (!this->values.empty()) {
+                    view.values = span_t< const data_stream_t >(
+                        this->values.data() + idx * probe_count, probe_count);
+                }
+                if (!this->events.empty()) {
+                    view.events = span_t< const event_t >(
+                        this->events.data() + idx * (probe_count + 1),
+                        probe_count + 1);
+                }
+            }
+            return view;
         }
 
-        inline sample_iterator begin()
+        inline sample_view_t operator[](size_t idx) const
+        {
+            return this->view(idx);
+        }
+
+        inline sample_iterator begin() const
         {
             return sample_iterator(0, this);
         }
 
-        inline sample_iterator end()
+        inline sample_iterator end() const
         {
             return sample_iterator(this->size(), this);
         }
+
+        // Return the count samples starting with sample first
+        inline slice_t slice(size_t first, size_t count) const
+        {
+            first = std::min(first, this->size());
+            count = std::min(count, this->size() - first);
+            return slice_t(this, this->begin() + difference_type(first),
+                this->begin() + difference_type(first + count));
+        }
+
+        // Return the samples with a time in [begin, end]
+        inline slice_t slice(
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end) const
+        {
+            auto first = std::lower_bound(this->begin(), this->end(), begin,
+                [](const sample_view_t& s, std::chrono::nanoseconds t) {
+                    return s.time < t;
+                });
+            auto last = std::upper_bound(first, this->end(), end,
+                [](std::chrono::nanoseconds t, const sample_view_t& s) {
+                    return t < s.time;
+                });
+            return slice_t(this, first, last);
+        }
+
+        private:
+        typedef sample_iterator::difference_type difference_type;
+
+        // Index of the first sample within the recording, which is the
+        // first one at or after begin_time as done by load_samples
+        inline size_t first_index() const
+        {
+            const auto interval = this->psi.interval().count();
+            if (this->begin_time.count() <= 0) {
+                return 0;
+            }
+            return size_t((this->begin_time.count() + interval - 1) / interval);
+        }
     };
 
     inline bool operator==(const samples_t& lhs, const samples_t& rhs)
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/energy_index_t.h"
+#include "pslib/v1_0/save_psi.h"
+
+// StdLib
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    // Magic bytes at the beginning of every .pei file
+    constexpr char pei_magic[ 4 ] = { 'P', 'E', 'I', '2' };
+
+    // Write index to a temporary file and replace the .pei file with it (see
+    // replace_file())
+    inline void save_energy_index(const pslib::v1_0::energy_index_t& index,
+        const std::string& directory, const std::string& base_name)
+    {
+        std::string filename = directory + "/" + base_name + ".tmp.pei";
+        std::ofstream pei_file(filename, std::ios::binary | std::ios::trunc);
+        if (!pei_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+
+        auto write = [&](const auto& value) {
+            pei_file.write(
+                reinterpret_cast< const char* >(&value), sizeof(value));
+        };
+        pei_file.write(pei_magic, sizeof(pei_magic));
+        write(index.checksum);
+        write(index.sampling_count);
+        write(index.data_count);
+        write(index.probe_count);
+        write(index.block_size);
+        write(index.revision);
+        write(uint64_t(index.cumulative.size()));
+        pei_file.write(reinterpret_cast< const char* >(index.cumulative.data()),
+            std::streamsize(
+                sizeof(cumulative_energy_t) * index.cumulative.size()));
+
+        pei_file.close();
+        if (!pei_file.good()) {
+            throw std::runtime_error("Unable to write " + filename);
+        }
+        pslib::v1_0::replace_file(
+            filename, directory + "/" + base_name + ".pei", directory);
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/event_index_t.h"
+#include "pslib/v1_0/save_psi.h"
+
+// StdLib
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    // Magic bytes at the beginning of every .pev file
+    constexpr char pev_magic[ 4 ] = { 'P', 'E', 'V', '2' };
+
+    // Size of the header in front of the occurrences of a .pev file, which
+    // ends with the revision and the number of occurrences
+    constexpr size_t pev_header_size =
+        sizeof(pev_magic) + sizeof(uint32_t) + 5 * sizeof(uint64_t);
+
+    // Write index to a temporary file and replace the .pev file with it (see
+    // replace_file()), so a crash never leaves a truncated .pev file
+    inline void save_event_index(const pslib::v1_0::event_index_t& index,
+        const std::string& directory, const std::string& base_name)
+    {
+        std::string filename = directory + "/" + base_name + ".tmp.pev";
+        std::ofstream pev_file(filename, std::ios::binary | std::ios::trunc);
+        if (!pev_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+
+        auto write = [&](const auto& value) {
+            pev_file.write(
+                reinterpret_cast< const char* >(&value), sizeof(value));
+        };
+        pev_file.write(pev_magic, sizeof(pev_magic));
+        write(index.checksum);
+        write(index.sampling_count);
+        write(index.data_count);
+        write(index.probe_count);
+        write(index.revision);
+        write(uint64_t(index.occurrences.size()));
+        pev_file.write(
+            reinterpret_cast< const char* >(index.occurrences.data()),
+            std::streamsize(
+                sizeof(event_occurrence_t) * index.occurrences.size()));
+
+        pev_file.close();
+        if (!pev_file.good()) {
+            throw std::runtime_error("Unable to write " + filename);
+        }
+        pslib::v1_0::replace_file(
+            filename, directory + "/" + base_name + ".pev", directory);
+    }
+}
@@ -23,6 +23,7 @@
 #pragma once
 
 // Ext
+#include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -43,6 +44,10 @@
 #include <string>
 #include <vector>
 
+// Posix
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace pslib::v1_0 {
 
     inline void save_psi(const pslib::v1_0::psi_t& psi,
@@ -64,6 +69,9 @@ namespace pslib::v1_0 {
         std::string checksum_value;
         cksum_hexsstr >> checksum_value;
         psi_xml.add("PSI.Checksum.<xmlattr>.Value", checksum_value);
+        if (psi.revision != 0) {
+            psi_xml.add("PSI.Revision.<xmlattr>.Value", psi.revision);
+        }
         psi_xml.add("PSI.Measurement.SamplingRate.<xmlattr>.Value",
             psi.sampling_rate / 1000);
         psi_xml.add("PSI.Measurement.SamplingCount.<xmlattr>.Value",
@@ -103,4 +111,40 @@ namespace pslib::v1_0 {
 
         boost::property_tree::write_xml(filename, psi_xml);
     }
+
+    // Wait until the contents of the file (or directory) filename reached
+    // the disk
+    inline void sync_file(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0 || ::fsync(fd) != 0) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            throw std::runtime_error("Unable to sync " + filename);
+        }
+        ::close(fd);
+    }
+
+    // Rename the completely written file tmp_filename over filename in
+    // directory, so readers either see the old or the new file. Both the
+    // temporary file and the directory are synced, so the new file has
+    // reached the disk when replace_file() returns.
+    inline void replace_file(const std::string& tmp_filename,
+        const std::string& filename, const std::string& directory)
+    {
+        pslib::v1_0::sync_file(tmp_filename);
+        boost::filesystem::rename(tmp_filename, filename);
+        pslib::v1_0::sync_file(directory);
+    }
+
+    // Like save_psi() but write to a temporary file first and replace the
+    // .psi file with it (see replace_file())
+    inline void replace_psi(const pslib::v1_0::psi_t& psi,
+        const std::string& directory, const std::string& base_name)
+    {
+        pslib::v1_0::save_psi(psi, directory, base_name + ".tmp");
+        pslib::v1_0::replace_file(directory + "/" + base_name + ".tmp.psi",
+            directory + "/" + base_name + ".psi", directory);
+    }
 }
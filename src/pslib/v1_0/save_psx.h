@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psx_t.h"
+#include "pslib/v1_0/save_psi.h"
+
+// StdLib
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace pslib::v1_0 {
+    // Magic bytes at the beginning of every .psx file, older versions are
+    // rejected and rebuilt by open_psx()
+    constexpr char psx_magic[ 4 ] = { 'P', 'S', 'X', '3' };
+
+    // Write psx to a temporary file and replace the .psx file with it (see
+    // replace_file())
+    inline void save_psx(const pslib::v1_0::psx_t& psx,
+        const std::string& directory, const std::string& base_name)
+    {
+        std::string filename = directory + "/" + base_name + ".tmp.psx";
+        std::ofstream psx_file(filename, std::ios::binary | std::ios::trunc);
+        if (!psx_file.is_open()) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+
+        auto write = [&](const auto& value) {
+            psx_file.write(
+                reinterpret_cast< const char* >(&value), sizeof(value));
+        };
+        psx_file.write(psx_magic, sizeof(psx_magic));
+        write(psx.checksum);
+        write(psx.sampling_count);
+        write(psx.data_count);
+        write(psx.probe_count);
+        write(psx.block_size);
+        write(psx.revision);
+        write(uint64_t(psx.levels.size()));
+        for (const auto& level : psx.levels) {
+            write(uint64_t(level.size()));
+            psx_file.write(reinterpret_cast< const char* >(level.data()),
+                std::streamsize(sizeof(probe_statistics_t) * level.size()));
+        }
+
+        psx_file.close();
+        if (!psx_file.good()) {
+            throw std::runtime_error("Unable to write " + filename);
+        }
+        pslib::v1_0::replace_file(
+            filename, directory + "/" + base_name + ".psx", directory);
+    }
+}
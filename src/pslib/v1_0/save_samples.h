@@ -26,17 +26,26 @@
 #include <boost/filesystem.hpp>
 
 // Own
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
 #include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/write_psd.h"
 
 // StdLib
 #include <chrono>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <ostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace pslib::v1_0 {
-    inline void save_samples(const pslib::v1_0::samples_t& samples,
-        const std::string& directory, const std::string& base_name)
+    // Throw if samples (a samples_t or soa_samples_t) can't be saved as a
+    // whole recording
+    template < typename Samples >
+    inline void check_saveable_samples(const Samples& samples)
     {
         if (samples.begin_time > std::chrono::nanoseconds(0)) {
             // TODO: Better Error
@@ -44,40 +53,77 @@ namespace pslib::v1_0 {
                                      "begin on 0 and cant be saved to .psd "
                                      "files");
         }
-        if (samples.end_time != samples.psi.length()) {
+        if (samples.end_time != samples.psi->length()) {
             // TODO: Better Error
             throw std::runtime_error("Given pslib::v1_0::sample_t doesn't end "
                                      "as specified in psi element");
         }
+    }
+
+    // Write the .psd file of psd with its slice of samples (a samples_t or
+    // soa_samples_t). write_records(out, index, count) writes the records of
+    // the count samples beginning with sample index to out and returns false
+    // if writing failed.
+    template < typename Samples, typename Writer >
+    inline void save_psd_records(const Samples& samples,
+        const pslib::v1_0::psd_t& psd, const std::string& directory,
+        const std::string& base_name, Writer&& write_records)
+    {
+        std::string psd_filename = directory + "/" + base_name + "_" +
+                                   std::to_string(psd.id) + ".psd";
+        std::ofstream psd_file(
+            psd_filename, std::ios::binary | std::ios::trunc);
+        if (!psd_file.is_open()) {
+            throw std::runtime_error("Unable to open " + psd_filename);
+        }
+
+        const auto index = pslib::v1_0::psd_first_sample(psd);
+        const auto count = size_t(psd.data_count);
+        if (index + count > samples.size()) {
+            throw std::runtime_error("Given pslib::v1_0::sample_t doesn't "
+                                     "hold the samples of " +
+                                     psd_filename);
+        }
+        if (!write_records(static_cast< std::ostream& >(psd_file), index,
+                count)) {
+            throw std::runtime_error("Unable to write " + psd_filename);
+        }
+        psd_file.flush();
+        psd_file.close();
 
-        for (auto& psd : samples.psi.psds) {
-            std::string psd_filename = directory + "/" + base_name + "_" +
-                                       std::to_string(psd.id) + ".psd";
-            std::ofstream psd_file(psd_filename);
-            // TODO: Error if ostream cant be opend
-            size_t writen_bytes = 0;
-            for (size_t i = 0; i < size_t(psd.data_count); ++i) {
-                auto index = i + (psd.offset > 0 ? size_t(psd.offset - 1) : 0);
-                auto s = samples.at(index);
-                for (auto& ds : s.values) {
-                    psd_file.write(
-                        reinterpret_cast< const char* >(&ds), sizeof(ds));
-                    writen_bytes += sizeof(ds);
-                }
-                for (auto& e : s.events) {
-                    psd_file.write(
-                        reinterpret_cast< const char* >(&e), sizeof(e));
-                    writen_bytes += sizeof(e);
-                }
-            }
-            psd_file.flush();
-            psd_file.close();
+        // If less then 1 GiB of data was writen, resize psd file to 1 GiB
+        const size_t writen_bytes =
+            count * pslib::v1_0::sample_size(*samples.psi);
+        if (writen_bytes < psd_file_size) {
+            boost::filesystem::resize_file(psd_filename, psd_file_size);
+        }
+    }
+
+    // Write the .psd file of psd with its slice of samples
+    inline void save_psd(const pslib::v1_0::samples_t& samples,
+        const pslib::v1_0::psd_t& psd, const std::string& directory,
+        const std::string& base_name, std::vector< char >& buffer)
+    {
+        const size_t probe_count = samples.psi->probes.size();
+        pslib::v1_0::save_psd_records(samples, psd, directory, base_name,
+            [&](std::ostream& out, size_t index, size_t count) {
+                // Write the records straight from values/events in large
+                // blocks
+                return pslib::v1_0::write_samples(out,
+                    samples.values.data() + index * probe_count,
+                    samples.events.data() + index * (probe_count + 1), count,
+                    probe_count, buffer);
+            });
+    }
+
+    inline void save_samples(const pslib::v1_0::samples_t& samples,
+        const std::string& directory, const std::string& base_name)
+    {
+        pslib::v1_0::check_saveable_samples(samples);
 
-            // If less then 1 GiB of data was writen, resize psd file to 1 GiB
-            if (writen_bytes < (1ul * 1024ul * 1024ul * 1024ul)) {
-                boost::filesystem::resize_file(
-                    psd_filename, 1ul * 1024ul * 1024ul * 1024ul);
-            }
+        std::vector< char > buffer;
+        for (auto& psd : samples.psi->psds) {
+            pslib::v1_0::save_psd(samples, psd, directory, base_name, buffer);
         }
     }
 }
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/run_workers.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/save_samples.h"
+
+// StdLib
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Same as save_samples but the .psd files are written by up to
+    // max_concurrency workers at once. A max_concurrency of 0 uses one worker
+    // per hardware thread; use a small value on spinning disks.
+    inline void save_samples_parallel(const pslib::v1_0::samples_t& samples,
+        const std::string& directory, const std::string& base_name,
+        size_t max_concurrency = 0)
+    {
+        pslib::v1_0::check_saveable_samples(samples);
+
+        const auto& psds = samples.psi->psds;
+        if (max_concurrency == 0) {
+            max_concurrency = std::max(
+                size_t(std::thread::hardware_concurrency()), size_t(1));
+        }
+        max_concurrency = std::min(max_concurrency, psds.size());
+
+        std::atomic< size_t > next_psd{ 0 };
+        pslib::v1_0::run_workers(max_concurrency, [&](size_t) {
+            std::vector< char > buffer;
+            for (auto i = next_psd++; i < psds.size(); i = next_psd++) {
+                pslib::v1_0::save_psd(
+                    samples, psds[ i ], directory, base_name, buffer);
+            }
+        });
+    }
+}
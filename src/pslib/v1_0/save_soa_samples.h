@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psd_t.h"
+#include "pslib/v1_0/save_samples.h"
+#include "pslib/v1_0/soa_samples_t.h"
+#include "pslib/v1_0/write_psd.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Interleave count samples of the columns of soa starting at sample idx
+    // into sample records. This is the inverse of decode_soa_samples.
+    inline void encode_soa_samples(
+        const soa_samples_t& soa, size_t idx, size_t count, char* records)
+    {
+        const size_t probe_count = soa.psi->probes.size();
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t record_size =
+            values_size + sizeof(event_t) * (probe_count + 1);
+        for (size_t p = 0; p < probe_count; ++p) {
+            char* ds = records + sizeof(data_stream_t) * p;
+            const auto current = soa.current[ p ].data() + idx;
+            const auto voltage = soa.voltage[ p ].data() + idx;
+            for (size_t i = 0; i < count; ++i, ds += record_size) {
+                std::memcpy(ds + offsetof(data_stream_t, current),
+                    current + i, sizeof(double));
+                std::memcpy(ds + offsetof(data_stream_t, voltage),
+                    voltage + i, sizeof(double));
+            }
+        }
+        for (size_t p = 0; p < probe_count + 1; ++p) {
+            char* e = records + values_size + sizeof(event_t) * p;
+            const auto events = soa.events[ p ].data() + idx;
+            for (size_t i = 0; i < count; ++i, e += record_size) {
+                std::memcpy(e, events + i, sizeof(event_t));
+            }
+        }
+    }
+
+    // Same as save_samples for samples in the structure-of-arrays layout
+    inline void save_soa_samples(const soa_samples_t& samples,
+        const std::string& directory, const std::string& base_name,
+        size_t block_size = psd_write_block_size)
+    {
+        pslib::v1_0::check_saveable_samples(samples);
+
+        const size_t record_size = pslib::v1_0::sample_size(*samples.psi);
+        const size_t block_count =
+            std::max(block_size / record_size, size_t(1));
+        std::vector< char > buffer;
+        for (const auto& psd : samples.psi->psds) {
+            pslib::v1_0::save_psd_records(samples, psd, directory, base_name,
+                [&](std::ostream& out, size_t index, size_t count) {
+                    buffer.resize(std::min(block_count, count) * record_size);
+                    for (size_t i = 0; i < count && out.good();) {
+                        const auto n = std::min(block_count, count - i);
+                        pslib::v1_0::encode_soa_samples(
+                            samples, index + i, n, buffer.data());
+                        out.write(
+                            buffer.data(), std::streamsize(n * record_size));
+                        i += n;
+                    }
+                    return out.good();
+                });
+        }
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Byte range of the sample records in a .psd file
+    class psd_range_t {
+        public:
+        // Index of the first sample of the psd within the recording
+        size_t first_sample;
+        size_t sample_count;
+        // Size of the records in the .psd file
+        size_t size;
+    };
+
+    // Shared, immutable handle to the metadata of a recording together with
+    // values derived from it. Copying a handle only copies a pointer, so
+    // all windows (samples_t etc.) and readers cut from one recording can
+    // refer to the same psi_t instead of owning a deep copy each.
+    //
+    // A handle has to be created explicitly from a psi_t (which copies or
+    // moves it once), so passing the same psi_t to several functions
+    // doesn't silently copy it for every call.
+    class shared_psi_t {
+        private:
+        class data_t {
+            public:
+            psi_t psi;
+            size_t probe_count;
+            size_t record_size;
+            std::chrono::nanoseconds interval;
+            std::chrono::duration< double > exact_interval;
+            std::vector< psd_range_t > psd_ranges;
+        };
+
+        std::shared_ptr< const data_t > m_data;
+
+        public:
+        inline explicit shared_psi_t(const psi_t& psi)
+            : shared_psi_t(psi_t(psi))
+        {
+        }
+
+        inline explicit shared_psi_t(psi_t&& psi)
+        {
+            auto data = std::make_shared< data_t >();
+            {
+                data->psi = std::move(psi);
+                data->probe_count = data->psi.probes.size();
+                data->record_size = pslib::v1_0::sample_size(data->psi);
+                data->interval = data->psi.sampling_interval();
+                data->exact_interval = std::chrono::duration< double >(
+                    1.0 / double(data->psi.sampling_rate));
+                for (const auto& psd : data->psi.psds) {
+                    auto range = psd_range_t();
+                    {
+                        range.first_sample =
+                            pslib::v1_0::psd_first_sample(psd);
+                        range.sample_count = size_t(psd.data_count);
+                        range.size = range.sample_count * data->record_size;
+                    }
+                    data->psd_ranges.push_back(range);
+                }
+            }
+            m_data = std::move(data);
+        }
+
+        inline const psi_t& operator*() const
+        {
+            return m_data->psi;
+        }
+
+        inline const psi_t* operator->() const
+        {
+            return &m_data->psi;
+        }
+
+        inline const psi_t& get() const
+        {
+            return m_data->psi;
+        }
+
+        // Number of probes
+        inline size_t probe_count() const
+        {
+            return m_data->probe_count;
+        }
+
+        // Size of a sample record as returned by sample_size()
+        inline size_t record_size() const
+        {
+            return m_data->record_size;
+        }
+
+        // Sampling interval as returned by psi_t::sampling_interval()
+        inline std::chrono::nanoseconds interval() const
+        {
+            return m_data->interval;
+        }
+
+        // Sampling interval in seconds without the truncation of interval()
+        // to whole nano seconds (e.g. 22675.736... ns at 44.1 kHz)
+        inline std::chrono::duration< double > exact_interval() const
+        {
+            return m_data->exact_interval;
+        }
+
+        // Sample and byte range of every psd (in the order of psi.psds)
+        inline const std::vector< psd_range_t >& psd_ranges() const
+        {
+            return m_data->psd_ranges;
+        }
+
+        // Number of handles sharing the metadata
+        inline long use_count() const
+        {
+            return m_data.use_count();
+        }
+    };
+
+    inline bool operator==(const shared_psi_t& lhs, const shared_psi_t& rhs)
+    {
+        return &*lhs == &*rhs || *lhs == *rhs;
+    }
+
+    inline bool operator!=(const shared_psi_t& lhs, const shared_psi_t& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
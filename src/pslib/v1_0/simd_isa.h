@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cstddef>
+
+namespace pslib::v1_0 {
+    // Instruction set used by the vectorized kernels
+    enum class SIMD_ISA {
+        SCALAR,
+        SSE2,
+        // AVX2 together with FMA
+        AVX2,
+        // AVX-512 Foundation
+        AVX512
+    };
+
+    // Return the number of doubles processed at once with isa
+    inline size_t simd_width(SIMD_ISA isa)
+    {
+        switch (isa) {
+            case SIMD_ISA::SSE2:
+                return 2;
+            case SIMD_ISA::AVX2:
+                return 4;
+            case SIMD_ISA::AVX512:
+                return 8;
+            case SIMD_ISA::SCALAR:
+            default:
+                return 1;
+        }
+    }
+
+    // Return the best instruction set supported by the running CPU
+    inline SIMD_ISA detect_simd_isa()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SIMD_ISA::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SIMD_ISA::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SIMD_ISA::SSE2;
+        }
+#endif
+        return SIMD_ISA::SCALAR;
+    }
+
+    // Same as detect_simd_isa(), but only detects the CPU once
+    inline SIMD_ISA cpu_simd_isa()
+    {
+        static const SIMD_ISA isa = pslib::v1_0::detect_simd_isa();
+        return isa;
+    }
+
+    // Return whether kernels for isa can run on this CPU
+    inline bool simd_isa_supported(SIMD_ISA isa)
+    {
+        return simd_width(isa) <= simd_width(pslib::v1_0::cpu_simd_isa());
+    }
+}
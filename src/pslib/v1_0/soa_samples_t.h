@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Structure-of-arrays variant of samples_t. Every quantity of every probe
+    // is stored in its own contiguous column, so per-probe computations can
+    // stream through memory instead of striding over the interleaved
+    // data_stream_t of all probes.
+    class soa_samples_t {
+        public:
+        shared_psi_t psi;
+        std::chrono::nanoseconds begin_time;
+        std::chrono::nanoseconds end_time;
+        // current[ p ][ i ] is the current of probe p in sample i
+        std::vector< std::vector< double > > current;
+        // voltage[ p ][ i ] is the voltage of probe p in sample i
+        std::vector< std::vector< double > > voltage;
+        // events[ p ][ i ] is the event of probe p in sample i, the last
+        // column holds the global events
+        std::vector< std::vector< event_t > > events;
+
+        public:
+        inline soa_samples_t(const shared_psi_t& p,
+            std::chrono::nanoseconds begin, std::chrono::nanoseconds end)
+            : psi{ p }
+            , begin_time{ begin }
+            , end_time{ end }
+            , current(p.probe_count())
+            , voltage(p.probe_count())
+            , events(p.probe_count() + 1)
+        {
+        }
+
+        inline size_t size() const
+        {
+            return this->events.back().size();
+        }
+
+        // Resize all columns to count samples
+        inline void resize(size_t count)
+        {
+            for (auto& column : this->current) {
+                column.resize(count);
+            }
+            for (auto& column : this->voltage) {
+                column.resize(count);
+            }
+            for (auto& column : this->events) {
+                column.resize(count);
+            }
+        }
+
+        inline data_stream_t value(size_t idx, size_t probe) const
+        {
+            return data_stream_t{ this->current[ probe ][ idx ],
+                this->voltage[ probe ][ idx ] };
+        }
+    };
+
+    inline bool operator==(const soa_samples_t& lhs, const soa_samples_t& rhs)
+    {
+        return lhs.psi == rhs.psi && lhs.begin_time == rhs.begin_time &&
+               lhs.end_time == rhs.end_time && lhs.current == rhs.current &&
+               lhs.voltage == rhs.voltage && lhs.events == rhs.events;
+    }
+
+    inline bool operator!=(const soa_samples_t& lhs, const soa_samples_t& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // Convert interleaved samples to the structure-of-arrays layout
+    inline soa_samples_t to_soa_samples(const samples_t& samples)
+    {
+        const size_t probe_count = samples.psi->probes.size();
+        const size_t count = samples.size();
+        auto soa = soa_samples_t(
+            samples.psi, samples.begin_time, samples.end_time);
+        soa.resize(count);
+        if (!samples.values.empty()) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                auto current = soa.current[ p ].data();
+                auto voltage = soa.voltage[ p ].data();
+                const data_stream_t* ds = samples.values.data() + p;
+                for (size_t i = 0; i < count; ++i, ds += probe_count) {
+                    current[ i ] = ds->current;
+                    voltage[ i ] = ds->voltage;
+                }
+            }
+        }
+        if (!samples.events.empty()) {
+            for (size_t p = 0; p < probe_count + 1; ++p) {
+                auto events = soa.events[ p ].data();
+                const event_t* e = samples.events.data() + p;
+                for (size_t i = 0; i < count; ++i, e += probe_count + 1) {
+                    events[ i ] = *e;
+                }
+            }
+        }
+        return soa;
+    }
+
+    // Convert samples in the structure-of-arrays layout back to interleaved
+    // samples
+    inline samples_t to_samples(const soa_samples_t& soa)
+    {
+        const size_t probe_count = soa.psi->probes.size();
+        const size_t count = soa.size();
+        auto samples = samples_t(soa.psi, soa.begin_time, soa.end_time);
+        samples.values.resize(count * probe_count);
+        samples.events.resize(count * (probe_count + 1));
+        for (size_t p = 0; p < probe_count; ++p) {
+            const auto current = soa.current[ p ].data();
+            const auto voltage = soa.voltage[ p ].data();
+            data_stream_t* ds = samples.values.data() + p;
+            for (size_t i = 0; i < count; ++i, ds += probe_count) {
+                ds->current = current[ i ];
+                ds->voltage = voltage[ i ];
+            }
+        }
+        for (size_t p = 0; p < probe_count + 1; ++p) {
+            const auto events = soa.events[ p ].data();
+            event_t* e = samples.events.data() + p;
+            for (size_t i = 0; i < count; ++i, e += probe_count + 1) {
+                *e = events[ i ];
+            }
+        }
+        return samples;
+    }
+}
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// StdLib
+#include <cstddef>
+
+namespace pslib::v1_0 {
+    // Non-owning view on size contiguous elements of type T
+    template < typename T >
+    class span_t {
+        private:
+        T* m_data;
+        size_t m_size;
+
+        public:
+        typedef T element_type;
+        typedef T* iterator;
+
+        inline span_t()
+            : m_data{ nullptr }
+            , m_size{ 0 }
+        {
+        }
+
+        inline span_t(T* data, size_t size)
+            : m_data{ data }
+            , m_size{ size }
+        {
+        }
+
+        inline T* data() const
+        {
+            return m_data;
+        }
+
+        inline size_t size() const
+        {
+            return m_size;
+        }
+
+        inline bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        inline T& operator[](size_t idx) const
+        {
+            return m_data[ idx ];
+        }
+
+        inline T* begin() const
+        {
+            return m_data;
+        }
+
+        inline T* end() const
+        {
+            return m_data + m_size;
+        }
+    };
+
+    template < typename T >
+    inline bool operator==(const span_t< T >& lhs, const span_t< T >& rhs)
+    {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (lhs[ i ] != rhs[ i ]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template < typename T >
+    inline bool operator!=(const span_t< T >& lhs, const span_t< T >& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
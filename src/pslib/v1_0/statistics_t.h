@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace pslib::v1_0 {
+    // How NaN values (e.g. of disconnected probes) enter the statistics
+    enum class NAN_POLICY {
+        // Ignore NaN values, the statistics describe the remaining values
+        SKIP,
+        // Any NaN value makes min, max, mean, rms and stddev NaN
+        PROPAGATE
+    };
+
+    // Running statistics of a single quantity. Instead of the sums of the
+    // values and their squares it keeps the mean and the sum of squared
+    // deviations from the mean (Welford), so the standard deviation of a
+    // small signal on a large offset doesn't cancel out. Two statistics are
+    // merged with the pairwise update of Chan et al.
+    class statistics_t {
+        public:
+        // Number of values added, not counting NaN values
+        uint64_t count = 0;
+        uint64_t nan_count = 0;
+        double min = std::numeric_limits< double >::infinity();
+        double max = -std::numeric_limits< double >::infinity();
+        // Mean of the values
+        double m1 = 0.0;
+        // Sum of the squared deviations of the values from m1
+        double m2 = 0.0;
+
+        public:
+        inline void add(double v)
+        {
+            if (std::isnan(v)) {
+                this->nan_count++;
+                return;
+            }
+            this->count++;
+            this->min = std::min(this->min, v);
+            this->max = std::max(this->max, v);
+            const auto delta = v - this->m1;
+            this->m1 += delta / double(this->count);
+            this->m2 += delta * (v - this->m1);
+        }
+
+        inline void add(const statistics_t& s)
+        {
+            this->nan_count += s.nan_count;
+            this->min = std::min(this->min, s.min);
+            this->max = std::max(this->max, s.max);
+            if (s.count == 0) {
+                return;
+            }
+            const auto total = this->count + s.count;
+            const auto delta = s.m1 - this->m1;
+            const auto weight = double(s.count) / double(total);
+            this->m1 += delta * weight;
+            this->m2 += s.m2 + delta * delta * double(this->count) * weight;
+            this->count = total;
+        }
+
+        // Apply policy to the added values. Only call this once all values
+        // have been added. Without any (non NaN) value min and max are NaN
+        // like the mean.
+        inline void apply(NAN_POLICY policy)
+        {
+            if (this->count == 0) {
+                this->min = std::numeric_limits< double >::quiet_NaN();
+                this->max = std::numeric_limits< double >::quiet_NaN();
+            }
+            if (policy == NAN_POLICY::PROPAGATE && this->nan_count > 0) {
+                this->min = std::numeric_limits< double >::quiet_NaN();
+                this->max = std::numeric_limits< double >::quiet_NaN();
+                this->m1 = std::numeric_limits< double >::quiet_NaN();
+                this->m2 = std::numeric_limits< double >::quiet_NaN();
+            }
+        }
+
+        inline double mean() const
+        {
+            if (this->count == 0) {
+                return std::numeric_limits< double >::quiet_NaN();
+            }
+            return this->m1;
+        }
+
+        inline double rms() const
+        {
+            const auto mean = this->mean();
+            return std::sqrt(mean * mean + this->m2 / double(this->count));
+        }
+
+        inline double stddev() const
+        {
+            return std::sqrt(this->m2 / double(this->count));
+        }
+    };
+
+    // Statistics of the current and voltage of a probe
+    class probe_statistics_t {
+        public:
+        statistics_t current;
+        statistics_t voltage;
+
+        public:
+        inline void add(const data_stream_t& v)
+        {
+            this->current.add(v.current);
+            this->voltage.add(v.voltage);
+        }
+
+        inline void add(const probe_statistics_t& s)
+        {
+            this->current.add(s.current);
+            this->voltage.add(s.voltage);
+        }
+
+        inline void apply(NAN_POLICY policy)
+        {
+            this->current.apply(policy);
+            this->voltage.apply(policy);
+        }
+    };
+}
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/build_event_index.h"
+#include "pslib/v1_0/event_index_t.h"
+#include "pslib/v1_0/load_event_index.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/sample_reader.h"
+#include "pslib/v1_0/save_event_index.h"
+#include "pslib/v1_0/shared_psi_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Patch the .pev file next to the .psi file of psi after the samples
+    // [first, first + count) were modified in place. The events of these
+    // samples are scanned again. If the number of their occurrences didn't
+    // change only those are overwritten in place, otherwise the .pev file
+    // is rewritten. The .pev file has to be built from the given (previous)
+    // revision of the recording, otherwise or if it can't be patched it is
+    // removed and rebuilt when opened next.
+    inline void update_event_index(const shared_psi_t& shared_psi,
+        uint64_t revision, size_t first, size_t count)
+    {
+        const psi_t& psi = *shared_psi;
+        auto filename = pslib::v1_0::psi_sidecar_filename(psi, ".pev");
+        if (count == 0 || !boost::filesystem::exists(filename)) {
+            return;
+        }
+
+        try {
+            auto index = pslib::v1_0::load_event_index(filename);
+            const auto matches = index.revision == revision;
+            index.revision = psi.revision;
+            if (!matches || pslib::v1_0::event_index_is_stale(index, psi)) {
+                throw std::runtime_error("Stale PEV file " + filename);
+            }
+
+            std::vector< event_occurrence_t > patched;
+            const auto slot_count = psi.probes.size() + 1;
+            const auto interval = shared_psi.interval();
+            auto reader = pslib::v1_0::sample_reader(shared_psi,
+                int64_t(first) * interval,
+                int64_t(first + count - 1) * interval);
+            while (auto block = reader.next()) {
+                pslib::v1_0::scan_events(block->events.data(),
+                    block->events.size(), slot_count, block->first, patched);
+            }
+
+            auto& occurrences = index.occurrences;
+            auto by_sample = [](const event_occurrence_t& o, uint64_t s) {
+                return o.sample < s;
+            };
+            const auto lower = std::lower_bound(occurrences.begin(),
+                occurrences.end(), uint64_t(first), by_sample);
+            const auto upper = std::lower_bound(
+                lower, occurrences.end(), uint64_t(first + count), by_sample);
+
+            if (size_t(upper - lower) != patched.size()) {
+                occurrences.insert(
+                    occurrences.erase(lower, upper), patched.begin(),
+                    patched.end());
+                auto path = boost::filesystem::path(filename);
+                auto directory = path.parent_path().string();
+                pslib::v1_0::save_event_index(index,
+                    directory.empty() ? "." : directory,
+                    path.stem().string());
+                return;
+            }
+
+            std::fstream pev_file(
+                filename, std::ios::binary | std::ios::in | std::ios::out);
+            if (!pev_file.is_open()) {
+                throw std::runtime_error("Unable to open " + filename);
+            }
+            pev_file.seekp(std::streamoff(pev_header_size +
+                                          sizeof(event_occurrence_t) *
+                                              size_t(lower -
+                                                     occurrences.begin())));
+            pev_file.write(reinterpret_cast< const char* >(patched.data()),
+                std::streamsize(sizeof(event_occurrence_t) * patched.size()));
+            // The revision in front of the number of occurrences is only
+            // written once all occurrences were patched
+            pev_file.seekp(
+                std::streamoff(pev_header_size - 2 * sizeof(uint64_t)));
+            pev_file.write(reinterpret_cast< const char* >(&index.revision),
+                sizeof(index.revision));
+            pev_file.close();
+            if (!pev_file.good()) {
+                throw std::runtime_error("Unable to write " + filename);
+            }
+        }
+        catch (std::runtime_error&) {
+            boost::filesystem::remove(filename);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/build_psx.h"
+#include "pslib/v1_0/load_psx.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/statistics_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Patch the .psx file next to the .psi file of psi after the samples
+    // [first, first + count) were modified in place. Only the level 0 blocks
+    // holding them and the O(log n) blocks above those are recomputed and
+    // rewritten with positional writes. The .psx file has to be built from
+    // the given (previous) revision of the recording, otherwise or if it
+    // can't be patched it is removed and rebuilt when opened next.
+    inline void update_psx(const shared_psi_t& shared_psi, uint64_t revision,
+        size_t first, size_t count)
+    {
+        const psi_t& psi = *shared_psi;
+        auto filename = pslib::v1_0::psi_sidecar_filename(psi, ".psx");
+        if (count == 0 || !boost::filesystem::exists(filename)) {
+            return;
+        }
+
+        try {
+            const auto file_size =
+                uint64_t(boost::filesystem::file_size(filename));
+            std::fstream psx_file(
+                filename, std::ios::binary | std::ios::in | std::ios::out);
+            if (!psx_file.is_open()) {
+                throw std::runtime_error("Unable to open " + filename);
+            }
+            std::vector< uint64_t > sizes;
+            auto psx = pslib::v1_0::read_psx_header(
+                psx_file, file_size, filename, sizes);
+            const auto header_size = uint64_t(psx_file.tellg());
+            const auto matches = psx.revision == revision;
+            psx.revision = psi.revision;
+            if (!matches || pslib::v1_0::psx_is_stale(psx, psi)) {
+                throw std::runtime_error("Stale PSX file " + filename);
+            }
+
+            const size_t probe_count = psi.probes.size();
+            const size_t block_size = size_t(psx.block_size);
+            const auto entry_size =
+                std::streamoff(sizeof(probe_statistics_t) * probe_count);
+            auto seek = [&](uint64_t offset, size_t block) {
+                return std::streamoff(offset) +
+                       std::streamoff(block) * entry_size;
+            };
+            auto read_blocks = [&](uint64_t offset, size_t block,
+                                   std::vector< probe_statistics_t >& level) {
+                psx_file.seekg(seek(offset, block));
+                psx_file.read(reinterpret_cast< char* >(level.data()),
+                    std::streamsize(
+                        sizeof(probe_statistics_t) * level.size()));
+                if (!psx_file.good()) {
+                    throw std::runtime_error("Unable to read " + filename);
+                }
+            };
+            auto write_blocks = [&](uint64_t offset, size_t block,
+                                    const std::vector< probe_statistics_t >&
+                                        level) {
+                psx_file.seekp(seek(offset, block));
+                psx_file.write(reinterpret_cast< const char* >(level.data()),
+                    std::streamsize(
+                        sizeof(probe_statistics_t) * level.size()));
+                if (!psx_file.good()) {
+                    throw std::runtime_error("Unable to write " + filename);
+                }
+            };
+
+            // Level 0 blocks [lo, hi] hold the patched samples
+            auto lo = first / block_size;
+            auto hi = (first + count - 1) / block_size;
+            std::vector< probe_statistics_t > level(
+                (hi - lo + 1) * probe_count);
+            const auto expected =
+                std::min((hi + 1) * block_size, size_t(psx.data_count)) -
+                lo * block_size;
+            if (pslib::v1_0::summarize_psx_blocks(shared_psi,
+                    psx.block_size, lo, hi - lo + 1, level.data()) !=
+                expected) {
+                throw std::runtime_error(
+                    "Unable to read the samples of " + psi.filename);
+            }
+            // Offset of the statistics of the current level
+            auto offset = header_size + sizeof(uint64_t);
+            write_blocks(offset, lo, level);
+
+            std::vector< probe_statistics_t > below;
+            for (size_t l = 1; l < sizes.size(); ++l) {
+                // Both children of every touched block, the last block of a
+                // level may have a single child
+                const auto below_first = (lo / 2) * 2;
+                const auto below_last = std::min(
+                    (hi / 2) * 2 + 2, size_t(sizes[ l - 1 ] / probe_count));
+                below.resize((below_last - below_first) * probe_count);
+                read_blocks(offset, below_first, below);
+
+                offset += sizes[ l - 1 ] * sizeof(probe_statistics_t) +
+                          sizeof(uint64_t);
+                lo /= 2;
+                hi /= 2;
+                level.assign((hi - lo + 1) * probe_count, probe_statistics_t());
+                pslib::v1_0::merge_psx_blocks(below.data(),
+                    below_last - below_first, level.data(), probe_count);
+                write_blocks(offset, lo, level);
+            }
+
+            // The revision is the second last field of the header and only
+            // written once all blocks were patched
+            psx_file.seekp(
+                std::streamoff(header_size - 2 * sizeof(uint64_t)));
+            psx_file.write(reinterpret_cast< const char* >(&psx.revision),
+                sizeof(psx.revision));
+            psx_file.close();
+            if (!psx_file.good()) {
+                throw std::runtime_error("Unable to write " + filename);
+            }
+        }
+        catch (std::runtime_error&) {
+            boost::filesystem::remove(filename);
+        }
+    }
+}
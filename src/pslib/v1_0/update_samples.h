@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+#include "pslib/v1_0/psd_filename.h"
+#include "pslib/v1_0/psd_layout.h"
+#include "pslib/v1_0/psi_t.h"
+#include "pslib/v1_0/samples_t.h"
+#include "pslib/v1_0/save_psi.h"
+#include "pslib/v1_0/shared_psi_t.h"
+#include "pslib/v1_0/update_event_index.h"
+#include "pslib/v1_0/update_psx.h"
+#include "pslib/v1_0/write_psd.h"
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Write psi (atomically) to its .psi file
+    inline void rewrite_psi(const psi_t& psi)
+    {
+        auto path = boost::filesystem::path(psi.filename);
+        auto directory = path.parent_path().string();
+        pslib::v1_0::replace_psi(psi,
+            directory.empty() ? std::string(".") : directory,
+            path.stem().string());
+    }
+
+    // Read, modify and rewrite count sample records starting at sample first
+    // in place. modify(records, first, n) is called for blocks of n records
+    // of the samples [first, first + n). The revision of psi is incremented
+    // and its .psi file is rewritten before the records are touched, so
+    // every sidecar file built before is stale even if this fails half way.
+    // The event counts of the psds are adjusted afterwards. The summary
+    // pyramid and the event index are patched by update_psx and
+    // update_event_index, the energy index holds cumulative sums which
+    // would have to be rewritten behind the patched samples and is rebuilt
+    // when opened next. An index which is still loaded is stale.
+    template < typename Modifier >
+    inline void update_psd_records(psi_t& psi, size_t first, size_t count,
+        Modifier&& modify, size_t block_size = psd_write_block_size)
+    {
+        const size_t probe_count = psi.probes.size();
+        const size_t record_size = pslib::v1_0::sample_size(psi);
+        const size_t block_count =
+            std::max(block_size / record_size, size_t(1));
+        if (first + count > pslib::v1_0::psd_sample_count(psi)) {
+            throw std::runtime_error(
+                "Sample range out of bounds of " + psi.filename);
+        }
+
+        if (count == 0) {
+            return;
+        }
+        const auto revision = psi.revision;
+        const auto patched_first = first;
+        const auto patched_count = count;
+        ++psi.revision;
+        pslib::v1_0::rewrite_psi(psi);
+
+        bool events_changed = false;
+        std::vector< char > buffer;
+        while (count > 0) {
+            const auto position = pslib::v1_0::psd_position(psi, first);
+            if (position.psd >= psi.psds.size()) {
+                throw std::runtime_error(
+                    "Missing psd for sample " + std::to_string(first) +
+                    " of " + psi.filename);
+            }
+            auto& psd = psi.psds[ position.psd ];
+            const auto psd_end = pslib::v1_0::psd_first_sample(psd) +
+                                 size_t(psd.data_count);
+            auto psd_count = std::min(count, psd_end - first);
+
+            auto psd_filename = pslib::v1_0::psd_filename(psi, psd);
+            std::fstream psd_file(
+                psd_filename, std::ios::binary | std::ios::in | std::ios::out);
+            if (!psd_file.is_open()) {
+                throw std::runtime_error("Unable to open " + psd_filename);
+            }
+            auto offset = position.offset;
+            while (psd_count > 0) {
+                const auto n = std::min(block_count, psd_count);
+                const auto size = n * record_size;
+                buffer.resize(size);
+                psd_file.seekg(std::streamoff(offset));
+                psd_file.read(buffer.data(), std::streamsize(size));
+                if (!psd_file) {
+                    throw std::runtime_error("Unable to read " + psd_filename);
+                }
+                const auto before = pslib::v1_0::count_record_events(
+                    buffer.data(), n, probe_count);
+                modify(buffer.data(), first, n);
+                const auto after = pslib::v1_0::count_record_events(
+                    buffer.data(), n, probe_count);
+                psd_file.seekp(std::streamoff(offset));
+                psd_file.write(buffer.data(), std::streamsize(size));
+                if (!psd_file) {
+                    throw std::runtime_error(
+                        "Unable to write " + psd_filename);
+                }
+                if (before != after) {
+                    psd.event_count += after - before;
+                    events_changed = true;
+                }
+                offset += size;
+                first += n;
+                count -= n;
+                psd_count -= n;
+            }
+        }
+
+        if (events_changed) {
+            pslib::v1_0::rewrite_psi(psi);
+        }
+
+        const auto shared_psi = shared_psi_t(psi);
+        pslib::v1_0::update_psx(
+            shared_psi, revision, patched_first, patched_count);
+        pslib::v1_0::update_event_index(
+            shared_psi, revision, patched_first, patched_count);
+    }
+
+    // Overwrite count samples starting at sample first with values (probe
+    // count data streams per sample) and events (probe count + 1 events per
+    // sample). Only the affected records are rewritten.
+    inline void update_samples(psi_t& psi, size_t first,
+        const data_stream_t* values, const event_t* events, size_t count)
+    {
+        const size_t probe_count = psi.probes.size();
+        pslib::v1_0::update_psd_records(psi, first, count,
+            [&](char* records, size_t block_first, size_t n) {
+                const auto i = block_first - first;
+                pslib::v1_0::encode_samples(values + i * probe_count,
+                    events + i * (probe_count + 1), n, probe_count, records);
+            });
+    }
+
+    // Overwrite the recording with samples, starting at the first sample at
+    // or after samples.begin_time (e.g. samples loaded and modified before)
+    inline void update_samples(psi_t& psi, const samples_t& samples)
+    {
+        if (samples.psi->probes.size() != psi.probes.size() ||
+            samples.values.size() != samples.size() * psi.probes.size() ||
+            samples.events.size() !=
+                samples.size() * (psi.probes.size() + 1)) {
+            throw std::runtime_error(
+                "Samples don't match the probes of " + psi.filename);
+        }
+        const auto interval = psi.sampling_interval().count();
+        const size_t first = samples.begin_time.count() > 0
+                                 ? size_t((samples.begin_time.count() +
+                                              interval - 1) /
+                                          interval)
+                                 : 0;
+        pslib::v1_0::update_samples(psi, first, samples.values.data(),
+            samples.events.data(), samples.size());
+    }
+
+    // Clear the bits of mask in all events of the samples with a time in
+    // [begin, end]. The default clears the events completely.
+    inline void clear_events(psi_t& psi, std::chrono::nanoseconds begin,
+        std::chrono::nanoseconds end, uint16_t mask = 0xFFFF)
+    {
+        const size_t probe_count = psi.probes.size();
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t record_size = pslib::v1_0::sample_size(psi);
+        const auto range = pslib::v1_0::sample_range(psi, begin, end);
+        pslib::v1_0::update_psd_records(psi, range.first, range.count,
+            [&](char* records, size_t, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    char* events = records + i * record_size + values_size;
+                    for (size_t j = 0; j < probe_count + 1; ++j) {
+                        auto e = pslib::v1_0::event_t();
+                        std::memcpy(
+                            &e, events + j * sizeof(event_t), sizeof(e));
+                        e.data = uint16_t(e.data & ~mask);
+                        std::memcpy(
+                            events + j * sizeof(event_t), &e, sizeof(e));
+                    }
+                }
+            });
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+#pragma once
+
+// Own
+#include "pslib/v1_0/data_stream_t.h"
+#include "pslib/v1_0/event_t.h"
+
+// StdLib
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace pslib::v1_0 {
+    // Default size of the blocks written at once to a .psd file
+    constexpr size_t psd_write_block_size = 4ul * 1024ul * 1024ul;
+
+    // Interleave count samples of values and events into sample records.
+    // This is the inverse of decode_samples.
+    inline void encode_samples(const data_stream_t* values,
+        const event_t* events, size_t count, size_t probe_count,
+        char* records)
+    {
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t events_size = sizeof(event_t) * (probe_count + 1);
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(records, values, values_size);
+            std::memcpy(records + values_size, events, events_size);
+            records += values_size + events_size;
+            values += probe_count;
+            events += probe_count + 1;
+        }
+    }
+
+    // Return the number of occured events in events
+    inline size_t count_events(const event_t* events, size_t count)
+    {
+        size_t occured = 0;
+        for (size_t i = 0; i < count; ++i) {
+            occured += (events[ i ].data & 0x8000) != 0 ? 1 : 0;
+        }
+        return occured;
+    }
+
+    // Same as count_events for the events of count encoded sample records
+    inline int64_t count_record_events(
+        const char* records, size_t count, size_t probe_count)
+    {
+        const size_t values_size = sizeof(data_stream_t) * probe_count;
+        const size_t record_size =
+            values_size + sizeof(event_t) * (probe_count + 1);
+        int64_t occured = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const char* events = records + i * record_size + values_size;
+            for (size_t j = 0; j < probe_count + 1; ++j) {
+                auto e = pslib::v1_0::event_t();
+                std::memcpy(&e, events + j * sizeof(event_t), sizeof(e));
+                occured += (e.data & 0x8000) != 0 ? 1 : 0;
+            }
+        }
+        return occured;
+    }
+
+    // Write count samples to out. The records are interleaved into blocks of
+    // (roughly) block_size bytes using buffer, which is resized as needed and
+    // may be reused between calls, and each block is written at once.
+    // Returns false if writing failed.
+    inline bool write_samples(std::ostream& out, const data_stream_t* values,
+        const event_t* events, size_t count, size_t probe_count,
+        std::vector< char >& buffer, size_t block_size = psd_write_block_size)
+    {
+        const size_t record_size = sizeof(data_stream_t) * probe_count +
+                                   sizeof(event_t) * (probe_count + 1);
+        const size_t block_count =
+            std::max(block_size / record_size, size_t(1));
+        buffer.resize(std::min(block_count, count) * record_size);
+
+        while (count > 0 && out.good()) {
+            const auto n = std::min(block_count, count);
+            pslib::v1_0::encode_samples(
+                values, events, n, probe_count, buffer.data());
+            out.write(buffer.data(), std::streamsize(n * record_size));
+            values += n * probe_count;
+            events += n * (probe_count + 1);
+            count -= n;
+        }
+        return out.good();
+    }
+}
@@ -0,0 +1,244 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.async_psd_writer.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i % 10 == 0 ? 0x8000 | j : j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    const auto probe_count = psi.probes.size();
+
+    // Blocking writes through a tiny queue, so the producer has to wait
+    {
+        auto writer = pslib::v1_0::async_psd_writer(
+            psi, ".", "test.async_psd_writer", 2, 16, 400);
+        size_t written = 0;
+        while (written < samples.size()) {
+            const auto n = std::min(size_t(7), samples.size() - written);
+            writer.write(samples.values.data() + written * probe_count,
+                samples.events.data() + written * (probe_count + 1), n);
+            written += n;
+            if (written == 700) {
+                writer.flush();
+                auto stats = writer.stats();
+                if (stats.written_batches != stats.pushed_batches) {
+                    std::cout << "Flush didn't drain the queue" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                // The flushed samples can be loaded before close(), across
+                // the rollover to the second psd
+                auto flushed_psi =
+                    pslib::v1_0::load_psi("./test.async_psd_writer.psi");
+                auto flushed = pslib::v1_0::load_samples(flushed_psi);
+                if (flushed_psi.sampling_count != 700 ||
+                    flushed_psi.psds.size() != 2 || flushed.size() != 700 ||
+                    flushed.at(699) != samples.at(699)) {
+                    std::cout << "Flushed samples not on disk" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        auto written_psi = writer.close();
+        auto stats = writer.stats();
+        if (written_psi.sampling_count != samples.size() ||
+            stats.pushed_batches != (samples.size() + 6) / 7 ||
+            stats.written_batches != stats.pushed_batches ||
+            stats.dropped_batches != 0 || stats.dropped_samples != 0) {
+            std::cout << "Unexpected stats" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.async_psd_writer.psi");
+    auto loaded_samples = pslib::v1_0::load_samples(loaded_psi);
+    if (loaded_psi.psds.size() != 4 ||
+        loaded_samples.values != samples.values ||
+        loaded_samples.events != samples.events) {
+        std::cout << "Samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Non-blocking writes, every accepted batch has to end up on disk
+    {
+        auto writer = pslib::v1_0::async_psd_writer(
+            psi, ".", "test.async_psd_writer_drop", 1, 10);
+        size_t accepted = 0;
+        size_t attempts = 0;
+        for (size_t i = 0; i < samples.size(); i += 10, ++attempts) {
+            if (writer.try_write(samples.values.data() + i * probe_count,
+                    samples.events.data() + i * (probe_count + 1), 10)) {
+                ++accepted;
+            }
+        }
+        auto written_psi = writer.close();
+        auto stats = writer.stats();
+        if (stats.pushed_batches != accepted ||
+            stats.dropped_batches != attempts - accepted ||
+            stats.dropped_samples != stats.dropped_batches * 10 ||
+            written_psi.sampling_count != accepted * 10) {
+            std::cout << "Unexpected drop stats" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    auto drop_psi = pslib::v1_0::load_psi("./test.async_psd_writer_drop.psi");
+    if (pslib::v1_0::load_samples(drop_psi).size() != drop_psi.sampling_count) {
+        std::cout << "Unexpected drop recording" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Writes larger than a slot are split across several slots, try_write()
+    // rejects them as a whole if they don't fit into the queue
+    {
+        auto writer = pslib::v1_0::async_psd_writer(
+            psi, ".", "test.async_psd_writer_split", 4, 16);
+        if (writer.try_write(samples.values.data(), samples.events.data(),
+                16 * 4 + 1)) {
+            std::cout << "Oversized batch accepted" << std::endl;
+            return EXIT_FAILURE;
+        }
+        writer.write(samples.values.data(), samples.events.data(),
+            samples.size() - 64);
+        writer.flush();
+        const auto rest = samples.size() - 64;
+        if (!writer.try_write(samples.values.data() + rest * probe_count,
+                samples.events.data() + rest * (probe_count + 1), 64)) {
+            std::cout << "Batch filling the queue rejected" << std::endl;
+            return EXIT_FAILURE;
+        }
+        writer.close();
+        auto stats = writer.stats();
+        if (stats.pushed_batches != (samples.size() - 64 + 15) / 16 + 4 ||
+            stats.dropped_batches != 1 || stats.dropped_samples != 65) {
+            std::cout << "Unexpected split stats" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    auto split_psi = pslib::v1_0::load_psi("./test.async_psd_writer_split.psi");
+    auto split_samples = pslib::v1_0::load_samples(split_psi);
+    if (split_samples.values != samples.values ||
+        split_samples.events != samples.events) {
+        std::cout << "Split samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Nothing drains the queue after close(), so writing or flushing has
+    // to fail instead of waiting forever
+    {
+        auto writer = pslib::v1_0::async_psd_writer(
+            psi, ".", "test.async_psd_writer_closed", 1, 1);
+        writer.write(samples.values.data(), samples.events.data(), 1);
+        writer.close();
+
+        size_t failed = 0;
+        try {
+            writer.flush();
+        }
+        catch (const std::runtime_error&) {
+            ++failed;
+        }
+        try {
+            writer.write(samples.values.data(), samples.events.data(), 1);
+        }
+        catch (const std::runtime_error&) {
+            ++failed;
+        }
+        try {
+            writer.try_write(samples.values.data(), samples.events.data(), 1);
+        }
+        catch (const std::runtime_error&) {
+            ++failed;
+        }
+        if (failed != 3 || writer.stats().pushed_batches != 1) {
+            std::cout << "Closed writer accepted samples" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.compact_samples.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.compact_samples");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.compact_samples");
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.compact_samples.psi");
+    const auto probe_count = loaded_psi.probes.size();
+    auto max_error = [&](const auto& compact) {
+        double error = 0.0;
+        for (size_t i = 0; i < compact.size(); ++i) {
+            for (size_t p = 0; p < probe_count; ++p) {
+                const auto& ds = samples.values[ i * probe_count + p ];
+                error = std::max(error,
+                    std::fabs(compact.current(i, p) - ds.current));
+                error = std::max(error,
+                    std::fabs(compact.voltage(i, p) - ds.voltage));
+            }
+        }
+        return error;
+    };
+
+    // float
+    auto floats = pslib::v1_0::to_compact_samples< float >(samples);
+    if (floats.size() != samples.size() ||
+        floats.values.size() != samples.size() * probe_count * 2 ||
+        !std::equal(floats.events.begin(), floats.events.end(),
+            samples.events.begin(), samples.events.end()) ||
+        max_error(floats) > 1e-4 ||
+        pslib::v1_0::to_samples(floats).events != samples.events) {
+        std::cout << "Unexpected float samples" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Scaled int32_t with the range of the samples as the probes have none
+    auto fixed = pslib::v1_0::to_compact_samples< int32_t >(samples);
+    if (fixed.size() != samples.size() || max_error(fixed) > 1e-6 ||
+        fixed.current_scales[ 1 ].offset != (0.1 + 1499.1) / 2.0) {
+        std::cout << "Unexpected fixed samples" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Scaled int32_t converted while loading, the probes have no range so
+    // the sub-unit part of the currents (i + 0.1) has to survive as well
+    auto unranged = pslib::v1_0::load_compact_samples< int32_t >(
+        pslib::v1_0::shared_psi_t(loaded_psi));
+    if (unranged.size() != samples.size() || max_error(unranged) > 1e-6 ||
+        std::fabs(unranged.current(0, 1) - 0.1) > 1e-9) {
+        std::cout << "Unexpected loaded samples without probe ranges"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Scaled int32_t with the probe ranges, converted while loading
+    for (auto& probe : loaded_psi.probes) {
+        probe.current_min = -10.0;
+        probe.current_max = 2000.0;
+        probe.voltage_min = -2000.0;
+        probe.voltage_max = 10.0;
+    }
+    const auto ranged_psi = pslib::v1_0::shared_psi_t(loaded_psi);
+    auto loaded = pslib::v1_0::load_compact_samples< int32_t >(ranged_psi);
+    auto loaded_float = pslib::v1_0::load_compact_samples< float >(
+        ranged_psi, std::chrono::milliseconds(100), std::chrono::seconds(1));
+    if (loaded.size() != samples.size() ||
+        !std::equal(loaded.events.begin(), loaded.events.end(),
+            samples.events.begin(), samples.events.end()) ||
+        max_error(loaded) > 1e-6 || loaded_float.size() != 901 ||
+        loaded_float.current(0, 1) != float(100.1) ||
+        loaded_float.events[ 0 ].data != 100) {
+        std::cout << "Unexpected loaded samples" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // NaN and values out of range
+    const auto scale = pslib::v1_0::compact_scale_t::from_range(-1.0, 1.0);
+    const auto nan = std::numeric_limits< double >::quiet_NaN();
+    using fixed_t = pslib::v1_0::fixed_samples_t;
+    if (!std::isnan(fixed_t::decode(fixed_t::encode(nan, scale), scale)) ||
+        fixed_t::decode(fixed_t::encode(5.0, scale), scale) != 1.0 ||
+        fixed_t::decode(fixed_t::encode(-5.0, scale), scale) != -1.0 ||
+        std::fabs(fixed_t::decode(fixed_t::encode(0.25, scale), scale) -
+                  0.25) > 1e-9) {
+        std::cout << "Unexpected fixed point conversion" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.energy_index.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.energy_index");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // Samples with NaN power, one of them the last sample of the recording
+    const auto nan = std::numeric_limits< double >::quiet_NaN();
+    samples.values[ 2 * 700 + 1 ].voltage = nan;
+    samples.values[ 2 * 1499 + 0 ].current = nan;
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.energy_index");
+
+
+    using pslib::v1_0::INTEGRATION;
+    auto shared_psi = pslib::v1_0::shared_psi_t(psi);
+    auto close = [](double a, double b) {
+        return std::fabs(a - b) <= 1e-12 * std::max(std::fabs(b), 1.0);
+    };
+    auto same = [&](const std::vector< pslib::v1_0::probe_energy_t >& a,
+                    const std::vector< pslib::v1_0::probe_energy_t >& b) {
+        for (size_t p = 0; p < 2; ++p) {
+            if (a[ p ].count != b[ p ].count ||
+                a[ p ].nan_count != b[ p ].nan_count ||
+                a[ p ].first_power != b[ p ].first_power ||
+                a[ p ].last_power != b[ p ].last_power ||
+                !close(a[ p ].energy(INTEGRATION::RECTANGLE),
+                    b[ p ].energy(INTEGRATION::RECTANGLE)) ||
+                !close(a[ p ].energy(), b[ p ].energy())) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Blocks that do and don't divide the recording, crossing .psd
+    // boundaries and spanning more than one .psd file
+    for (uint64_t block_size : { 1, 64, 100, 500, 700, 1500, 4096 }) {
+        auto index =
+            pslib::v1_0::build_energy_index(shared_psi, block_size, 1);
+        if (index.data_count != 1500 || index.probe_count != 2 ||
+            index.block_count() != (1500 + block_size - 1) / block_size ||
+            index.at(0, 0).power_sum.value() != 0.0 ||
+            index.at(index.block_count(), 1).nan_count != 1 ||
+            index.at(index.block_count(), 0).nan_count != 1) {
+            std::cout << "Unexpected index with blocks of " << block_size
+                      << " samples" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // The parallel build yields the same index
+        auto parallel =
+            pslib::v1_0::build_energy_index(shared_psi, block_size, 4);
+        for (size_t i = 0; i < index.cumulative.size(); ++i) {
+            if (parallel.cumulative[ i ].nan_count !=
+                    index.cumulative[ i ].nan_count ||
+                !close(parallel.cumulative[ i ].power_sum.value(),
+                    index.cumulative[ i ].power_sum.value())) {
+                std::cout << "Unexpected parallel index entry " << i
+                          << " with blocks of " << block_size << " samples"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // Every range matches the energy streamed from the .psd files
+        const auto points = { 0, 1, 63, 64, 99, 100, 128, 499, 500, 501,
+            700, 701, 1000, 1001, 1400, 1498, 1499, 1500 };
+        for (int64_t begin : points) {
+            for (int64_t end : points) {
+                auto indexed = pslib::v1_0::indexed_probe_energy(index,
+                    shared_psi, std::chrono::milliseconds(begin),
+                    std::chrono::milliseconds(end));
+                auto streamed = pslib::v1_0::probe_energy(shared_psi,
+                    std::chrono::milliseconds(begin),
+                    std::chrono::milliseconds(end));
+                if (!same(indexed, streamed)) {
+                    std::cout << "Unexpected energy of [" << begin << ", "
+                              << end << "] with blocks of " << block_size
+                              << " samples" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        if (!same(pslib::v1_0::indexed_probe_energy(index, shared_psi),
+                pslib::v1_0::probe_energy(shared_psi))) {
+            std::cout << "Unexpected energy of the recording" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Save and load round trip
+    auto index = pslib::v1_0::build_energy_index(shared_psi, 100);
+    pslib::v1_0::save_energy_index(index, "./", "test.energy_index");
+    auto loaded = pslib::v1_0::load_energy_index("./test.energy_index.pei");
+    if (loaded.checksum != index.checksum ||
+        loaded.block_size != index.block_size ||
+        loaded.cumulative.size() != index.cumulative.size() ||
+        loaded.at(15, 1).power_sum.value() !=
+            index.at(15, 1).power_sum.value() ||
+        pslib::v1_0::energy_index_is_stale(loaded, psi)) {
+        std::cout << "Unexpected loaded index" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A stale index is rejected by queries and rebuilt when opened
+    auto changed = psi;
+    changed.checksum = 1;
+    auto changed_psi = pslib::v1_0::shared_psi_t(changed);
+    bool rejected = false;
+    try {
+        pslib::v1_0::indexed_probe_energy(loaded, changed_psi);
+    }
+    catch (std::runtime_error&) {
+        rejected = true;
+    }
+    if (!rejected || !pslib::v1_0::energy_index_is_stale(loaded, changed)) {
+        std::cout << "Stale index not detected" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto opened = pslib::v1_0::open_energy_index(changed_psi, 64);
+    auto reopened = pslib::v1_0::load_energy_index("./test.energy_index.pei");
+    if (opened.checksum != 1 || opened.block_size != 64 ||
+        reopened.checksum != 1 || reopened.block_size != 64) {
+        std::cout << "Stale index not rebuilt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Asking for another block size rebuilds the index as well
+    if (pslib::v1_0::open_energy_index(changed_psi, 32).block_size != 32 ||
+        pslib::v1_0::load_energy_index("./test.energy_index.pei")
+                .block_size != 32) {
+        std::cout << "Index with another block size reused" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A corrupt sample count is rejected before allocating the index for it
+    {
+        std::fstream pei_file("./test.energy_index.pei",
+            std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t huge = uint64_t(-1) - 1;
+        pei_file.seekp(4 + sizeof(uint32_t) + sizeof(uint64_t));
+        pei_file.write(reinterpret_cast< const char* >(&huge), sizeof(huge));
+    }
+    rejected = false;
+    try {
+        pslib::v1_0::load_energy_index("./test.energy_index.pei");
+    }
+    catch (std::runtime_error&) {
+        rejected = true;
+    }
+    if (!rejected ||
+        pslib::v1_0::open_energy_index(changed_psi, 32).data_count !=
+            pslib::v1_0::psd_sample_count(changed)) {
+        std::cout << "Corrupt index not rebuilt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Invalid block sizes are rejected
+    rejected = false;
+    try {
+        pslib::v1_0::build_energy_index(shared_psi, 0);
+    }
+    catch (std::runtime_error&) {
+        rejected = true;
+    }
+    if (!rejected) {
+        std::cout << "Block size of 0 not rejected" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.event_index.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.event_index");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i % 0x7FFF);
+                    if (i % 97 == j) {
+                        e.data |= 0x8000;
+                    }
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.event_index");
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.event_index.psi");
+    const auto slot_count = psi.probes.size() + 1;
+
+    // All expected occurences
+    std::vector< pslib::v1_0::event_occurrence_t > expected;
+    for (size_t i = 0; i < samples.events.size(); ++i) {
+        auto e = samples.events[ i ];
+        if (e.occured()) {
+            expected.push_back(pslib::v1_0::event_occurrence_t{
+                i / slot_count, uint16_t(i % slot_count), e.value(), 0 });
+        }
+    }
+
+    boost::filesystem::remove("./test.event_index.pev");
+    auto built = pslib::v1_0::open_event_index(
+        pslib::v1_0::shared_psi_t(loaded_psi));
+    auto index = pslib::v1_0::load_event_index("./test.event_index.pev");
+    if (built.occurrences != expected || index.occurrences != expected ||
+        pslib::v1_0::event_index_is_stale(index, loaded_psi)) {
+        std::cout << "Unexpected event index with "
+                  << index.occurrences.size() << " instead of "
+                  << expected.size() << " occurences" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The padding of the occurences is written as 0 and the temporary file
+    // is renamed over the .pev file
+    for (const auto& o : index.occurrences) {
+        if (o.reserved != 0) {
+            std::cout << "Padding of occurence not zeroed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (boost::filesystem::exists("./test.event_index.tmp.pev")) {
+        std::cout << "Temporary pev file left behind" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Query by time range, code and slot
+    const auto interval = psi.sampling_interval();
+    auto all = pslib::v1_0::find_events(index, loaded_psi);
+    if (all != expected) {
+        return EXIT_FAILURE;
+    }
+    auto window = pslib::v1_0::find_events(
+        index, loaded_psi, interval * 97, interval * 194);
+    if (window.size() != 4 || window[ 0 ].sample != 97 ||
+        window[ 0 ].slot != 0 || window[ 2 ].sample != 99 ||
+        window[ 2 ].slot != 2 || window[ 3 ].sample != 194) {
+        std::cout << "Unexpected events in window" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto by_code = pslib::v1_0::find_events(index, loaded_psi,
+        std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), 98, 1);
+    if (by_code.size() != 1 || by_code[ 0 ].sample != 98 ||
+        by_code[ 0 ].slot != 1 || by_code[ 0 ].value != 98) {
+        std::cout << "Unexpected events by code" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto by_slot = pslib::v1_0::find_events(index, loaded_psi,
+        std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), -1, 2);
+    for (const auto& o : by_slot) {
+        if (o.slot != 2 || o.sample % 97 != 2) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (by_slot.size() != (samples.size() - 2 + 96) / 97) {
+        std::cout << "Found " << by_slot.size() << " events on slot 2"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A changed psi makes the index stale
+    auto changed_psi = loaded_psi;
+    changed_psi.checksum = 42;
+    if (!pslib::v1_0::event_index_is_stale(index, changed_psi) ||
+        pslib::v1_0::event_index_is_stale(
+            pslib::v1_0::open_event_index(
+                pslib::v1_0::shared_psi_t(changed_psi)),
+            changed_psi)) {
+        return EXIT_FAILURE;
+    }
+
+    // Queries reject a stale index
+    try {
+        pslib::v1_0::find_events(index, changed_psi);
+        std::cout << "Stale index not rejected" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.load_envelope.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.load_envelope");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i == 777 && j == 1 ? 0x8005 : i);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.load_envelope");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.load_envelope.psi"));
+    const auto probe_count = psi.probes.size();
+
+    // Check the envelope against the full-rate samples
+    auto check = [&](const pslib::v1_0::envelope_t& envelope,
+                     const pslib::v1_0::samples_t& expected) {
+        size_t idx = 0;
+        for (size_t b = 0; b < envelope.size(); ++b) {
+            const auto& bucket = envelope.buckets[ b ];
+            if (bucket.time != expected.at(idx).time) {
+                return false;
+            }
+            bool event = false;
+            for (size_t p = 0; p < probe_count; ++p) {
+                double c_min = INFINITY, c_max = -INFINITY, c_sum = 0;
+                double v_min = INFINITY, v_max = -INFINITY, v_sum = 0;
+                for (size_t i = idx; i < idx + bucket.sample_count; ++i) {
+                    auto v = expected.values[ i * probe_count + p ];
+                    c_min = std::min(c_min, v.current);
+                    c_max = std::max(c_max, v.current);
+                    c_sum += v.current;
+                    v_min = std::min(v_min, v.voltage);
+                    v_max = std::max(v_max, v.voltage);
+                    v_sum += v.voltage;
+                }
+                for (size_t i = idx; i < idx + bucket.sample_count; ++i) {
+                    for (size_t e = 0; e < probe_count + 1; ++e) {
+                        auto ev = expected.events[ i * (probe_count + 1) + e ];
+                        event = event || ev.occured();
+                    }
+                }
+                const auto n = double(bucket.sample_count);
+                const auto& s = envelope.value(b, p);
+                if (std::fabs(s.current_min - c_min) > 1e-9 ||
+                    std::fabs(s.current_max - c_max) > 1e-9 ||
+                    std::fabs(s.current_mean - c_sum / n) > 1e-9 ||
+                    std::fabs(s.voltage_min - v_min) > 1e-9 ||
+                    std::fabs(s.voltage_max - v_max) > 1e-9 ||
+                    std::fabs(s.voltage_mean - v_sum / n) > 1e-9) {
+                    std::cout << "Bucket " << b << " differs" << std::endl;
+                    return false;
+                }
+            }
+            if (bucket.event != event) {
+                std::cout << "Bucket " << b << " event differs" << std::endl;
+                return false;
+            }
+            idx += bucket.sample_count;
+        }
+        return idx == expected.size();
+    };
+
+    auto envelope = pslib::v1_0::load_envelope(loaded_psi, 100);
+    if (envelope.size() != 100 || envelope.bucket_size != 15 ||
+        !check(envelope, samples)) {
+        std::cout << "Envelope of whole recording differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+    size_t event_buckets = 0;
+    for (const auto& bucket : envelope.buckets) {
+        event_buckets += bucket.event ? 1 : 0;
+    }
+    if (event_buckets != 1) {
+        std::cout << "Expected a single bucket with events" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Window with a bucket count not dividing the sample count
+    auto begin = std::chrono::milliseconds(450);
+    auto end = std::chrono::milliseconds(1050);
+    auto window = pslib::v1_0::load_envelope(loaded_psi, 7, begin, end);
+    if (window.size() != 7 ||
+        !check(window, pslib::v1_0::load_samples(loaded_psi, begin, end))) {
+        std::cout << "Envelope of window differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // More buckets than samples
+    auto fine = pslib::v1_0::load_envelope(loaded_psi, 5000);
+    if (fine.size() != samples.size() || !check(fine, samples)) {
+        std::cout << "Full-rate envelope differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A NaN value enters min, max and mean of its bucket the same way
+    samples.values[ 3 * probe_count ].current =
+        std::numeric_limits< double >::quiet_NaN();
+    pslib::v1_0::save_psi(psi, "./", "test.load_envelope_nan");
+    pslib::v1_0::save_samples(samples, "./", "test.load_envelope_nan");
+    auto nan_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.load_envelope_nan.psi"));
+    const auto skipped = pslib::v1_0::load_envelope(nan_psi, 100).value(0, 0);
+    const auto propagated =
+        pslib::v1_0::load_envelope(nan_psi, 100, std::chrono::nanoseconds(0),
+            std::chrono::nanoseconds(-1), pslib::v1_0::NAN_POLICY::PROPAGATE)
+            .value(0, 0);
+    if (skipped.current_min != 0.0 || skipped.current_max != 14.0 ||
+        std::fabs(skipped.current_mean - 102.0 / 14.0) > 1e-9 ||
+        !std::isnan(propagated.current_min) ||
+        !std::isnan(propagated.current_max) ||
+        !std::isnan(propagated.current_mean) ||
+        propagated.voltage_max != 0.0) {
+        std::cout << "Unexpected NaN handling" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
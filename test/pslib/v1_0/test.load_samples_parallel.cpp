@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.load_samples_parallel.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.load_samples_parallel");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.load_samples_parallel");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.load_samples_parallel.psi"));
+
+    // Whole recording with small chunks to get many more tasks than workers
+    auto loaded = pslib::v1_0::load_samples_parallel(loaded_psi,
+        std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), 4, 1000);
+    if (loaded != samples) {
+        std::cout << "Loaded samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Window crossing a psd boundary
+    auto begin = std::chrono::milliseconds(450);
+    auto end = std::chrono::milliseconds(1050);
+    auto expected = pslib::v1_0::load_samples(loaded_psi, begin, end);
+    auto window = pslib::v1_0::load_samples_parallel(
+        loaded_psi, begin, end, 3, 1000);
+    if (window != expected) {
+        std::cout << "Loaded window differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Default thread count and chunk size
+    if (pslib::v1_0::load_samples_parallel(loaded_psi) != samples) {
+        std::cout << "Loaded samples with defaults differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A gap in the psds ends the samples, nothing behind it is returned
+    auto gap_psi = *loaded_psi;
+    gap_psi.psds.erase(gap_psi.psds.begin() + 1);
+    auto before_gap = pslib::v1_0::load_samples_parallel(
+        pslib::v1_0::shared_psi_t(gap_psi), std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds(-1), 2, 1000);
+    if (before_gap.size() != 500 ||
+        !std::equal(before_gap.values.begin(), before_gap.values.end(),
+            samples.values.begin())) {
+        std::cout << "Loaded " << before_gap.size()
+                  << " samples in front of a gap" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (pslib::v1_0::load_samples(gap_psi) != before_gap) {
+        std::cout << "Loaders disagree on a gap" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
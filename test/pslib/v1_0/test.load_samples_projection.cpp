@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.load_samples_projection.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.load_samples_projection");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.load_samples_projection");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.load_samples_projection.psi"));
+    const auto probe_count = psi.probes.size();
+
+    // Currents of the second probe plus events over a psd boundary
+    {
+        auto projection = pslib::v1_0::projection_t();
+        {
+            projection.probes = { 1 };
+            projection.voltage = false;
+        }
+        auto begin = std::chrono::milliseconds(450);
+        auto end = std::chrono::milliseconds(1050);
+        auto loaded =
+            pslib::v1_0::load_samples(loaded_psi, projection, begin, end);
+        if (loaded.psi->probes.size() != 1 ||
+            loaded.psi->probes[ 0 ] != psi.probes[ 1 ] ||
+            loaded.size() != 601) {
+            std::cout << "Unexpected projected psi" << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            auto s = loaded.at(i);
+            auto expected = samples.at(450 + i);
+            if (s.time != expected.time ||
+                s.values[ 0 ].current != expected.values[ 1 ].current ||
+                !std::isnan(s.values[ 0 ].voltage) ||
+                s.events.size() != 2 || s.events[ 0 ] != expected.events[ 1 ] ||
+                s.events[ 1 ] != expected.events[ 2 ]) {
+                std::cout << "Projected sample " << i << " differs"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Voltages of all probes in reverse order without events
+    {
+        auto projection = pslib::v1_0::projection_t();
+        {
+            projection.probes = { 1, 0 };
+            projection.current = false;
+            projection.events = false;
+        }
+        auto loaded = pslib::v1_0::load_samples(loaded_psi, projection);
+        if (loaded.size() != samples.size() || !loaded.events.empty()) {
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            for (size_t j = 0; j < probe_count; ++j) {
+                const auto& v = loaded.values[ i * probe_count + j ];
+                const auto& e =
+                    samples.values[ i * probe_count + (probe_count - 1 - j) ];
+                if (v.voltage != e.voltage || !std::isnan(v.current)) {
+                    std::cout << "Voltage " << i << " differs" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    // Events only
+    {
+        auto projection = pslib::v1_0::projection_t();
+        {
+            projection.current = false;
+            projection.voltage = false;
+        }
+        auto loaded = pslib::v1_0::load_samples(loaded_psi, projection);
+        if (loaded.size() != samples.size() || !loaded.values.empty() ||
+            loaded.events != samples.events) {
+            std::cout << "Events differ" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (loaded.at(10).values.size() != 0 ||
+            loaded.at(10).events.size() != probe_count + 1) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Full projection equals load_samples
+    if (pslib::v1_0::load_samples(loaded_psi, pslib::v1_0::projection_t()) !=
+        samples) {
+        std::cout << "Full projection differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.load_samples_range.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.load_samples_range");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.load_samples_range");
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.load_samples_range.psi");
+
+    // Each window is checked against the matching slice of the written
+    // samples: first/last sample index of the window
+    const size_t windows[][ 2 ] = {
+        { 0, 0 }, { 0, 499 }, { 450, 1050 }, { 500, 500 }, { 1000, 1499 },
+        { 1499, 1499 }, { 10, 1490 },
+    };
+    const auto interval = loaded_psi.sampling_interval();
+    const auto probe_count = loaded_psi.probes.size();
+    for (const auto& window : windows) {
+        auto loaded = pslib::v1_0::load_samples(loaded_psi,
+            window[ 0 ] * interval, window[ 1 ] * interval);
+        const auto count = window[ 1 ] - window[ 0 ] + 1;
+        if (loaded.size() != count) {
+            std::cout << "Window [" << window[ 0 ] << ", " << window[ 1 ]
+                      << "] loaded " << loaded.size() << " samples"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (loaded.at(i) != samples.at(window[ 0 ] + i)) {
+                std::cout << "Window [" << window[ 0 ] << ", " << window[ 1 ]
+                          << "] differs at " << i << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        if (loaded.values.size() != count * probe_count ||
+            loaded.events.size() != count * (probe_count + 1)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Begin not aligned to the sampling interval starts on the next sample
+    auto unaligned = pslib::v1_0::load_samples(loaded_psi,
+        interval * 700 + std::chrono::nanoseconds(1), interval * 799);
+    if (unaligned.size() != 99 ||
+        unaligned.values.front() != samples.values.at(701 * probe_count)) {
+        std::cout << "Unaligned window loaded wrong samples" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Window behind the end of the recording
+    auto behind = pslib::v1_0::load_samples(
+        loaded_psi, interval * 1500, interval * 2000);
+    if (behind.size() != 0) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// Ext
+#include <boost/filesystem.hpp>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.map_samples.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.map_samples");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.map_samples");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.map_samples.psi"));
+
+    // Whole recording
+    auto mapped_samples = pslib::v1_0::map_samples(loaded_psi);
+    if (mapped_samples.size() != samples.size()) {
+        std::cout << "Mapped " << mapped_samples.size()
+                  << " samples instead of " << samples.size() << std::endl;
+        return EXIT_FAILURE;
+    }
+    size_t idx = 0;
+    for (auto s : mapped_samples) {
+        if (s != samples.at(idx)) {
+            std::cout << "Sample " << idx << " differs" << std::endl;
+            return EXIT_FAILURE;
+        }
+        ++idx;
+    }
+
+    // Window crossing a psd boundary
+    auto begin = std::chrono::milliseconds(450);
+    auto end = std::chrono::milliseconds(1050);
+    auto loaded_window = pslib::v1_0::load_samples(loaded_psi, begin, end);
+    auto mapped_window = pslib::v1_0::map_samples(loaded_psi, begin, end);
+    if (mapped_window.size() != loaded_window.size()) {
+        std::cout << "Mapped " << mapped_window.size()
+                  << " samples instead of " << loaded_window.size()
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < mapped_window.size(); ++i) {
+        if (mapped_window.at(i) != loaded_window.at(i)) {
+            std::cout << "Window sample " << i << " differs" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Random access
+    auto it = mapped_samples.begin() + 1200;
+    if (mapped_samples.end() - it != 300 || it[ -700 ] != samples.at(500) ||
+        it->value(1) != samples.at(1200).values[ 1 ]) {
+        std::cout << "Random access differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Truncated psd file, the view ends where the file ends like
+    // load_samples does
+    boost::filesystem::resize_file(
+        pslib::v1_0::psd_filename(*loaded_psi, loaded_psi->psds[ 1 ]),
+        250 * pslib::v1_0::sample_size(*loaded_psi));
+    auto truncated = pslib::v1_0::map_samples(loaded_psi);
+    auto loaded_truncated = pslib::v1_0::load_samples(loaded_psi);
+    if (truncated.size() != 750 ||
+        truncated.size() != loaded_truncated.size() ||
+        truncated.at(749) != samples.at(749)) {
+        std::cout << "Mapped " << truncated.size()
+                  << " samples of a truncated psd" << std::endl;
+        return EXIT_FAILURE;
+    }
+    try {
+        truncated.at(750);
+        std::cout << "Sample beyond the truncated psd is accessible"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::out_of_range&) {
+    }
+
+    // A missing psd file throws like load_samples does
+    auto missing = *loaded_psi;
+    missing.psds[ 1 ].id = 99;
+    try {
+        pslib::v1_0::map_samples(pslib::v1_0::shared_psi_t(missing));
+        std::cout << "Missing psd not reported" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.mapped_psd_writer.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i % 10 == 0 ? 0x8000 | j : j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    const auto probe_count = psi.probes.size();
+
+    // Fill the records in place, committing only part of each reservation
+    {
+        auto writer = pslib::v1_0::mapped_psd_writer(
+            psi, ".", "test.mapped_psd_writer", 400);
+        // Committing nothing before the first reservation
+        writer.commit(0);
+        size_t written = 0;
+        while (written < samples.size()) {
+            auto records = writer.reserve(250);
+            const auto n =
+                std::min(records.size(), std::min(size_t(200),
+                                             samples.size() - written));
+            for (size_t i = 0; i < n; ++i) {
+                const auto idx = written + i;
+                for (size_t j = 0; j < probe_count; ++j) {
+                    records.set_value(
+                        i, j, samples.values[ idx * probe_count + j ]);
+                }
+                for (size_t j = 0; j < probe_count + 1; ++j) {
+                    records.set_event(
+                        i, j, samples.events[ idx * (probe_count + 1) + j ]);
+                }
+                if (records.value(i, 0) !=
+                    samples.values[ idx * probe_count ]) {
+                    std::cout << "Unexpected record value" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+            writer.commit(n);
+            written += n;
+            if (written == 600) {
+                writer.sync();
+                // The synced samples can be loaded before close(), across
+                // the rollover to the second psd
+                auto synced_psi =
+                    pslib::v1_0::load_psi("./test.mapped_psd_writer.psi");
+                auto synced = pslib::v1_0::load_samples(synced_psi);
+                if (synced_psi.sampling_count != 600 ||
+                    synced_psi.psds.size() != 2 || synced.size() != 600 ||
+                    synced.at(599) != samples.at(599)) {
+                    std::cout << "Synced samples not on disk" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        try {
+            writer.reserve(10);
+            writer.commit(11);
+            std::cout << "Committed unreserved records" << std::endl;
+            return EXIT_FAILURE;
+        }
+        catch (const std::runtime_error&) {
+        }
+        auto written_psi = writer.close();
+        if (written_psi.sampling_count != samples.size()) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.mapped_psd_writer.psi");
+    if (loaded_psi.sampling_count != psi.sampling_count ||
+        loaded_psi.psds.size() != 4) {
+        std::cout << "Unexpected psi" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < loaded_psi.psds.size(); ++i) {
+        const auto& psd = loaded_psi.psds[ i ];
+        const auto count = i < 3 ? 400 : 300;
+        if (psd.data_count != count || psd.event_count != count / 10 * 3 ||
+            psd.offset != (i > 0 ? int64_t(i * 400 + 1) : 0) ||
+            boost::filesystem::file_size(pslib::v1_0::psd_filename(
+                loaded_psi, psd)) != pslib::v1_0::psd_file_size) {
+            std::cout << "Unexpected psd " << psd.id << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto loaded_samples = pslib::v1_0::load_samples(loaded_psi);
+    if (loaded_samples.values != samples.values ||
+        loaded_samples.events != samples.events) {
+        std::cout << "Samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Copying write() with the default psd capacity, closed on destruction
+    {
+        auto writer = pslib::v1_0::mapped_psd_writer(
+            psi, ".", "test.mapped_psd_writer_single");
+        writer.write(samples.values.data(), samples.events.data(), 700);
+        writer.write(samples.values.data() + 700 * probe_count,
+            samples.events.data() + 700 * (probe_count + 1), 800);
+    }
+    auto single_psi =
+        pslib::v1_0::load_psi("./test.mapped_psd_writer_single.psi");
+    auto single_samples = pslib::v1_0::load_samples(single_psi);
+    if (single_psi.psds.size() != 1 ||
+        single_samples.values != samples.values ||
+        single_samples.events != samples.events) {
+        std::cout << "Single psd recording differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.prefetch_sample_reader.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.prefetch_sample_reader");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.prefetch_sample_reader");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.prefetch_sample_reader.psi"));
+
+    // Whole recording with blocks crossing the psd boundaries
+    for (size_t queue_depth = 1; queue_depth <= 3; ++queue_depth) {
+        auto reader = pslib::v1_0::prefetch_sample_reader(loaded_psi,
+            std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), 128,
+            queue_depth);
+        size_t idx = 0;
+        while (auto block = reader.next()) {
+            if (block->first != idx) {
+                std::cout << "Unexpected block at " << idx << std::endl;
+                return EXIT_FAILURE;
+            }
+            for (auto s : *block) {
+                if (s != samples.at(idx)) {
+                    std::cout << "Sample " << idx << " differs" << std::endl;
+                    return EXIT_FAILURE;
+                }
+                ++idx;
+            }
+        }
+        if (idx != samples.size()) {
+            std::cout << "Read " << idx << " samples instead of "
+                      << samples.size() << std::endl;
+            return EXIT_FAILURE;
+        }
+        // Reading behind the end stays at the end
+        if (reader.next() != nullptr) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Stop reading before the end
+    {
+        auto reader = pslib::v1_0::prefetch_sample_reader(loaded_psi,
+            std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), 16);
+        if (reader.next() == nullptr) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Errors of the background thread are forwarded
+    {
+        auto missing_psi = *loaded_psi;
+        missing_psi.filename = "./test.prefetch_sample_reader_missing.psi";
+        auto reader = pslib::v1_0::prefetch_sample_reader(
+            pslib::v1_0::shared_psi_t(missing_psi));
+        try {
+            reader.next();
+            std::cout << "Missing psd not reported" << std::endl;
+            return EXIT_FAILURE;
+        }
+        catch (std::runtime_error&) {
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
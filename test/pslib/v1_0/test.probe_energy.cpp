@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.probe_energy.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.probe_energy");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.probe_energy");
+
+    using pslib::v1_0::INTEGRATION;
+    using pslib::v1_0::NAN_POLICY;
+    using pslib::v1_0::SIMD_ISA;
+    const auto isas = { SIMD_ISA::SCALAR, SIMD_ISA::SSE2, SIMD_ISA::AVX2,
+        SIMD_ISA::AVX512 };
+    const auto nan = std::numeric_limits< double >::quiet_NaN();
+
+    auto close = [](double a, double b) {
+        return std::fabs(a - b) <= 1e-12 * std::max(std::fabs(b), 1.0);
+    };
+
+    // Every instruction set has to yield the power sums of an exact
+    // reference for all strides (including the scalar fallback for more
+    // than 8 probes) and row counts (including the tails)
+    for (size_t probe_count = 1; probe_count <= 9; ++probe_count) {
+        for (size_t count : { 0, 1, 3, 17, 64, 1031, 20011 }) {
+            std::vector< pslib::v1_0::data_stream_t > values(
+                count * probe_count);
+            std::vector< long double > expected(probe_count, 0.0);
+            std::vector< uint64_t > expected_nans(probe_count, 0);
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[ i ].current = double((i * 7919) % 1013) / 1000.0;
+                values[ i ].voltage =
+                    i % 4999 == 13 ? nan : 3.3 - double(i % 33) / 100.0;
+                if (std::isnan(values[ i ].voltage)) {
+                    expected_nans[ i % probe_count ]++;
+                }
+                else {
+                    expected[ i % probe_count ] +=
+                        (long double)(values[ i ].current) *
+                        values[ i ].voltage;
+                }
+            }
+            for (auto isa : isas) {
+                for (auto policy :
+                    { NAN_POLICY::SKIP, NAN_POLICY::PROPAGATE }) {
+                    std::vector< pslib::v1_0::compensated_sum_t > sums(
+                        probe_count);
+                    std::vector< uint64_t > nan_counts(probe_count, 0);
+                    pslib::v1_0::add_power_sums(
+                        reinterpret_cast< const double* >(values.data()),
+                        count, probe_count, sums.data(), nan_counts.data(),
+                        policy, isa);
+                    for (size_t p = 0; p < probe_count; ++p) {
+                        const auto sum = sums[ p ].value();
+                        const bool ok = policy == NAN_POLICY::PROPAGATE &&
+                                                expected_nans[ p ] > 0
+                                            ? std::isnan(sum)
+                                            : close(sum,
+                                                  double(expected[ p ]));
+                        if (!ok || nan_counts[ p ] != expected_nans[ p ]) {
+                            std::cout << "Power sums differ for "
+                                      << probe_count << " probes, " << count
+                                      << " samples, isa " << int(isa)
+                                      << std::endl;
+                            return EXIT_FAILURE;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Compensated summation keeps the energy of a long constant load exact,
+    // a naive sum of the same powers is off by more than 1e-6
+    {
+        const size_t count = 1000000;
+        auto constant = pslib::v1_0::soa_samples_t(
+            samples.psi, std::chrono::nanoseconds(0),
+            std::chrono::nanoseconds(0));
+        constant.resize(count);
+        std::fill(constant.current[ 0 ].begin(), constant.current[ 0 ].end(),
+            0.1);
+        std::fill(constant.voltage[ 0 ].begin(), constant.voltage[ 0 ].end(),
+            1.0);
+        std::fill(constant.current[ 1 ].begin(), constant.current[ 1 ].end(),
+            0.1);
+        std::fill(constant.voltage[ 1 ].begin(), constant.voltage[ 1 ].end(),
+            1.0);
+        auto interleaved = pslib::v1_0::to_samples(constant);
+        for (auto isa : isas) {
+            auto soa = pslib::v1_0::probe_energy(
+                constant, NAN_POLICY::SKIP, isa);
+            auto aos = pslib::v1_0::probe_energy(
+                interleaved, NAN_POLICY::SKIP, isa);
+            // 1 ms interval
+            if (std::fabs(soa[ 0 ].energy(INTEGRATION::RECTANGLE) - 100.0) >
+                    1e-12 ||
+                std::fabs(aos[ 1 ].energy(INTEGRATION::RECTANGLE) - 100.0) >
+                    1e-12 ||
+                std::fabs(aos[ 1 ].power_sum.value() - 100000.0) > 1e-9 ||
+                std::fabs(aos[ 0 ].average_power() - 0.1) > 1e-15) {
+                std::cout << "Inaccurate energy with isa " << int(isa)
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // At 44.1 kHz the interval isn't a whole number of nano seconds, one
+    // second of 1 W has to yield 1 J instead of 44100 * 22675 ns
+    {
+        auto cd_psi = psi;
+        cd_psi.sampling_rate = 44100;
+        const auto shared_cd_psi = pslib::v1_0::shared_psi_t(cd_psi);
+        auto constant = pslib::v1_0::soa_samples_t(shared_cd_psi,
+            std::chrono::nanoseconds(0), std::chrono::nanoseconds(0));
+        constant.resize(44100);
+        for (size_t p = 0; p < 2; ++p) {
+            std::fill(constant.current[ p ].begin(),
+                constant.current[ p ].end(), 0.5);
+            std::fill(constant.voltage[ p ].begin(),
+                constant.voltage[ p ].end(), 2.0);
+        }
+        auto interleaved = pslib::v1_0::to_samples(constant);
+        auto block = pslib::v1_0::sample_block_t();
+        block.probe_count = 2;
+        block.sampling_interval = shared_cd_psi.interval();
+        block.exact_interval = shared_cd_psi.exact_interval();
+        block.first = 0;
+        block.values.assign(
+            interleaved.values.begin(), interleaved.values.end());
+        std::vector< pslib::v1_0::probe_energy_t > streamed(2);
+        pslib::v1_0::add_probe_energy(block, streamed);
+        for (const auto& energy :
+            { pslib::v1_0::probe_energy(constant)[ 0 ],
+                pslib::v1_0::probe_energy(interleaved)[ 1 ], streamed[ 0 ] }) {
+            if (!close(energy.energy(INTEGRATION::RECTANGLE), 1.0) ||
+                !close(energy.average_power(), 1.0) ||
+                energy.duration(INTEGRATION::RECTANGLE) !=
+                    std::chrono::seconds(1)) {
+                std::cout << "Inexact energy at 44.1 kHz: "
+                          << energy.energy(INTEGRATION::RECTANGLE) << " J"
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Samples holding events only have no power
+    {
+        auto projection = pslib::v1_0::projection_t();
+        projection.current = false;
+        projection.voltage = false;
+        auto events = pslib::v1_0::load_samples(samples.psi, projection);
+        auto event_energies = pslib::v1_0::probe_energy(events);
+        auto event_window = pslib::v1_0::probe_energy(events,
+            std::chrono::milliseconds(0), std::chrono::milliseconds(10));
+        if (events.size() != 1500 || event_energies.size() != 2 ||
+            event_energies[ 0 ].count != 0 || event_window[ 1 ].count != 0 ||
+            event_energies[ 1 ].energy() != 0.0 ||
+            !pslib::v1_0::power_series(events, 0).empty()) {
+            std::cout << "Unexpected energy without values" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Energy of the recording, loaded, streamed and in columns
+    long double rectangle[ 2 ] = { 0.0, 0.0 };
+    for (size_t i = 0; i < samples.values.size(); ++i) {
+        rectangle[ i % 2 ] += (long double)(samples.values[ i ].current) *
+                              samples.values[ i ].voltage;
+    }
+    auto energies = pslib::v1_0::probe_energy(samples);
+    auto streamed = pslib::v1_0::probe_energy(samples.psi);
+    auto columns =
+        pslib::v1_0::probe_energy(pslib::v1_0::to_soa_samples(samples));
+    for (size_t p = 0; p < 2; ++p) {
+        const auto first = samples.values[ p ].current *
+                           samples.values[ p ].voltage;
+        const auto last = samples.values[ 2 * 1499 + p ].current *
+                          samples.values[ 2 * 1499 + p ].voltage;
+        const auto trapezoid = rectangle[ p ] - (first + last) / 2.0;
+        for (const auto& energy :
+            { energies[ p ], streamed[ p ], columns[ p ] }) {
+            if (energy.count != 1500 || energy.nan_count != 0 ||
+                !close(energy.energy(INTEGRATION::RECTANGLE),
+                    double(rectangle[ p ] / 1000.0)) ||
+                !close(energy.energy(INTEGRATION::TRAPEZOID),
+                    double(trapezoid / 1000.0)) ||
+                energy.duration(INTEGRATION::RECTANGLE) !=
+                    std::chrono::milliseconds(1500) ||
+                energy.duration() != std::chrono::milliseconds(1499) ||
+                !close(energy.average_power(INTEGRATION::RECTANGLE),
+                    double(rectangle[ p ] / 1500.0))) {
+                std::cout << "Unexpected energy of probe " << p << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // A window streamed from the .psd files (crossing a .psd boundary)
+    // matches the same window in memory
+    auto window = pslib::v1_0::probe_energy(
+        samples.psi, std::chrono::milliseconds(480),
+        std::chrono::milliseconds(1020));
+    auto in_memory = pslib::v1_0::probe_energy(samples,
+        std::chrono::milliseconds(480), std::chrono::milliseconds(1020));
+    for (size_t p = 0; p < 2; ++p) {
+        if (window[ p ].count != 541 || in_memory[ p ].count != 541 ||
+            !close(window[ p ].energy(), in_memory[ p ].energy()) ||
+            window[ p ].duration() != std::chrono::milliseconds(540) ||
+            window[ p ].first_power !=
+                samples.values[ 2 * 480 + p ].current *
+                    samples.values[ 2 * 480 + p ].voltage) {
+            std::cout << "Unexpected window energy" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // NaN policies
+    samples.values[ 0 ].voltage = nan;
+    auto skipped = pslib::v1_0::probe_energy(samples, NAN_POLICY::SKIP);
+    auto propagated =
+        pslib::v1_0::probe_energy(samples, NAN_POLICY::PROPAGATE);
+    if (skipped[ 0 ].nan_count != 1 || skipped[ 0 ].first_power != 0.0 ||
+        !close(skipped[ 0 ].energy(INTEGRATION::RECTANGLE),
+            energies[ 0 ].energy(INTEGRATION::RECTANGLE)) ||
+        propagated[ 0 ].nan_count != 1 ||
+        !std::isnan(propagated[ 0 ].energy()) ||
+        propagated[ 1 ].energy() != energies[ 1 ].energy()) {
+        std::cout << "Unexpected NaN handling" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.probe_statistics.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.probe_statistics");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.probe_statistics");
+
+    using pslib::v1_0::NAN_POLICY;
+    using pslib::v1_0::SIMD_ISA;
+    const auto isas = { SIMD_ISA::SCALAR, SIMD_ISA::SSE2, SIMD_ISA::AVX2,
+        SIMD_ISA::AVX512 };
+
+    auto same = [](const pslib::v1_0::statistics_t& lhs,
+                    const pslib::v1_0::statistics_t& rhs) {
+        auto close = [](double a, double b) {
+            return std::fabs(a - b) <= 1e-9 * std::max(std::fabs(b), 1.0);
+        };
+        return lhs.count == rhs.count && lhs.nan_count == rhs.nan_count &&
+               lhs.min == rhs.min && lhs.max == rhs.max &&
+               close(lhs.m1, rhs.m1) && close(lhs.m2, rhs.m2);
+    };
+
+    // Every instruction set has to yield the statistics of the scalar
+    // reference for all strides (including the scalar fallback for more
+    // than 8 probes) and row counts (including the tails)
+    for (size_t probe_count = 1; probe_count <= 9; ++probe_count) {
+        for (size_t count : { 0, 1, 3, 17, 64, 1031, 20011 }) {
+            std::vector< pslib::v1_0::data_stream_t > values(
+                count * probe_count);
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[ i ].current = double((i * 7919) % 1013) - 500.0;
+                values[ i ].voltage = i % 4999 == 13
+                                          ? std::numeric_limits<
+                                                double >::quiet_NaN()
+                                          : double(i % 33) / 10.0;
+            }
+            std::vector< pslib::v1_0::probe_statistics_t > expected(
+                probe_count);
+            for (size_t i = 0; i < values.size(); ++i) {
+                expected[ i % probe_count ].add(values[ i ]);
+            }
+            for (auto isa : isas) {
+                std::vector< pslib::v1_0::probe_statistics_t > stats(
+                    probe_count);
+                pslib::v1_0::add_probe_statistics(
+                    values.data(), count, stats, isa);
+                for (size_t p = 0; p < probe_count; ++p) {
+                    if (!same(stats[ p ].current, expected[ p ].current) ||
+                        !same(stats[ p ].voltage, expected[ p ].voltage)) {
+                        std::cout << "Statistics differ for " << probe_count
+                                  << " probes, " << count
+                                  << " samples, isa " << int(isa)
+                                  << std::endl;
+                        return EXIT_FAILURE;
+                    }
+                }
+            }
+        }
+    }
+
+    // A small signal on a large offset keeps its standard deviation, which
+    // the difference of the mean square and the squared mean cancels out
+    {
+        const size_t count = 100003;
+        std::vector< pslib::v1_0::data_stream_t > values(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto noise = double(int((i * 7919) % 1013) - 506) / 506.0;
+            values[ i ].current = 1000.0 + 1e-6 * noise;
+            values[ i ].voltage = 3.3 + 1e-3 * noise;
+        }
+        long double mean[ 2 ] = { 0.0, 0.0 };
+        for (const auto& v : values) {
+            mean[ 0 ] += v.current;
+            mean[ 1 ] += v.voltage;
+        }
+        mean[ 0 ] /= count;
+        mean[ 1 ] /= count;
+        long double m2[ 2 ] = { 0.0, 0.0 };
+        for (const auto& v : values) {
+            m2[ 0 ] += (v.current - mean[ 0 ]) * (v.current - mean[ 0 ]);
+            m2[ 1 ] += (v.voltage - mean[ 1 ]) * (v.voltage - mean[ 1 ]);
+        }
+        const double stddev[ 2 ] = { double(std::sqrt(m2[ 0 ] / count)),
+            double(std::sqrt(m2[ 1 ] / count)) };
+        for (auto isa : isas) {
+            std::vector< pslib::v1_0::probe_statistics_t > stats(1);
+            pslib::v1_0::add_probe_statistics(
+                values.data(), count, stats, isa);
+            if (std::fabs(stats[ 0 ].current.stddev() - stddev[ 0 ]) >
+                    1e-6 * stddev[ 0 ] ||
+                std::fabs(stats[ 0 ].voltage.stddev() - stddev[ 1 ]) >
+                    1e-9 * stddev[ 1 ] ||
+                std::fabs(stats[ 0 ].voltage.mean() - double(mean[ 1 ])) >
+                    1e-12) {
+                std::cout << "Inaccurate standard deviation with isa "
+                          << int(isa) << ": "
+                          << stats[ 0 ].current.stddev() << " A, "
+                          << stats[ 0 ].voltage.stddev() << " V" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Statistics of the recording, loaded, streamed and in columns
+    auto stats = pslib::v1_0::probe_statistics(samples);
+    const auto& current = stats[ 0 ].current;
+    if (stats.size() != 2 || current.count != 1500 || current.min != 0.0 ||
+        current.max != 1499.0 || current.mean() != 749.5 ||
+        std::fabs(current.stddev() - std::sqrt((1500.0 * 1500.0 - 1) / 12)) >
+            1e-6 ||
+        stats[ 1 ].voltage.max != 1.0 || stats[ 1 ].voltage.min != -1498.0) {
+        std::cout << "Unexpected statistics" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto streamed = pslib::v1_0::probe_statistics(samples.psi);
+    auto columns = pslib::v1_0::probe_statistics(
+        pslib::v1_0::to_soa_samples(samples));
+    for (size_t p = 0; p < 2; ++p) {
+        if (!same(streamed[ p ].current, stats[ p ].current) ||
+            !same(streamed[ p ].voltage, stats[ p ].voltage) ||
+            !same(columns[ p ].current, stats[ p ].current) ||
+            !same(columns[ p ].voltage, stats[ p ].voltage)) {
+            std::cout << "Statistics of probe " << p << " differ"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // A window streamed from the .psd files matches the same slice in memory
+    auto window = pslib::v1_0::probe_statistics(
+        samples.psi, std::chrono::milliseconds(480),
+        std::chrono::milliseconds(1020));
+    auto slice = pslib::v1_0::probe_statistics(samples.slice(
+        std::chrono::milliseconds(480), std::chrono::milliseconds(1020)));
+    if (window[ 0 ].current.count != 541 || window[ 0 ].current.min != 480.0 ||
+        !same(window[ 1 ].voltage, slice[ 1 ].voltage) ||
+        !same(window[ 0 ].current, slice[ 0 ].current)) {
+        std::cout << "Unexpected window statistics" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Samples holding events only have no values to summarise
+    {
+        auto projection = pslib::v1_0::projection_t();
+        projection.current = false;
+        projection.voltage = false;
+        auto events = pslib::v1_0::load_samples(samples.psi, projection);
+        auto event_stats = pslib::v1_0::probe_statistics(events);
+        auto event_slice = pslib::v1_0::probe_statistics(events.slice(
+            std::chrono::milliseconds(0), std::chrono::milliseconds(10)));
+        if (events.size() != 1500 || event_stats.size() != 2 ||
+            event_stats[ 0 ].current.count != 0 ||
+            event_stats[ 1 ].voltage.count != 0 ||
+            event_slice[ 1 ].current.count != 0) {
+            std::cout << "Unexpected statistics without values" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // NaN policies
+    samples.values[ 10 ].current = std::numeric_limits< double >::quiet_NaN();
+    auto skipped = pslib::v1_0::probe_statistics(samples, NAN_POLICY::SKIP);
+    auto propagated =
+        pslib::v1_0::probe_statistics(samples, NAN_POLICY::PROPAGATE);
+    if (skipped[ 0 ].current.count != 1499 ||
+        skipped[ 0 ].current.nan_count != 1 ||
+        skipped[ 0 ].current.max != 1499.0 ||
+        std::isnan(skipped[ 0 ].current.mean()) ||
+        propagated[ 0 ].current.nan_count != 1 ||
+        !std::isnan(propagated[ 0 ].current.min) ||
+        !std::isnan(propagated[ 0 ].current.mean()) ||
+        !std::isnan(propagated[ 0 ].current.stddev()) ||
+        propagated[ 1 ].current.max != 1499.1) {
+        std::cout << "Unexpected NaN handling" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A window of NaN values only has no min and max either
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples.values[ i * psi.probes.size() ].voltage =
+            std::numeric_limits< double >::quiet_NaN();
+    }
+    auto all_nan = pslib::v1_0::probe_statistics(samples, NAN_POLICY::SKIP);
+    if (all_nan[ 0 ].voltage.count != 0 ||
+        !std::isnan(all_nan[ 0 ].voltage.min) ||
+        !std::isnan(all_nan[ 0 ].voltage.max) ||
+        !std::isnan(all_nan[ 0 ].voltage.mean())) {
+        std::cout << "Unexpected statistics without values" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.psd_writer_append.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i % 10 == 0 ? 0x8000 | j : j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    const auto probe_count = psi.probes.size();
+    auto write = [&](pslib::v1_0::psd_writer& writer, size_t first,
+                     size_t count) {
+        writer.write(samples.values.data() + first * probe_count,
+            samples.events.data() + first * (probe_count + 1), count);
+    };
+
+    // Initial recording with 1000 samples, psds of 400, 400 and 200 samples
+    {
+        auto writer =
+            pslib::v1_0::psd_writer(psi, ".", "test.psd_writer_append", 400);
+        write(writer, 0, 1000);
+    }
+
+    // Fill up the last psd and start a new one
+    {
+        auto writer =
+            pslib::v1_0::psd_writer("./test.psd_writer_append.psi", 400);
+        write(writer, 1000, 150);
+        write(writer, 1150, 150);
+        auto appended_psi = writer.close();
+        if (appended_psi.sampling_count != 1300 ||
+            appended_psi.psds.size() != 4) {
+            std::cout << "Unexpected psi after first append" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Continue the last psd without a capacity limit
+    {
+        auto writer =
+            pslib::v1_0::psd_writer("./test.psd_writer_append.psi");
+        write(writer, 1300, 200);
+    }
+
+    if (boost::filesystem::exists("./test.psd_writer_append.tmp.psi")) {
+        std::cout << "Temporary psi left behind" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.psd_writer_append.psi");
+    const int64_t counts[] = { 400, 400, 400, 300 };
+    if (loaded_psi.sampling_count != psi.sampling_count ||
+        loaded_psi.psds.size() != 4) {
+        std::cout << "Unexpected psi" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < loaded_psi.psds.size(); ++i) {
+        const auto& psd = loaded_psi.psds[ i ];
+        if (psd.data_count != counts[ i ] ||
+            psd.event_count != counts[ i ] / 10 * 3 ||
+            psd.offset != (i > 0 ? int64_t(i * 400 + 1) : 0) ||
+            boost::filesystem::file_size(pslib::v1_0::psd_filename(
+                loaded_psi, psd)) != pslib::v1_0::psd_file_size) {
+            std::cout << "Unexpected psd " << psd.id << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto loaded_samples = pslib::v1_0::load_samples(loaded_psi);
+    if (loaded_samples.values != samples.values ||
+        loaded_samples.events != samples.events) {
+        std::cout << "Samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.psx.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.psx");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.psx");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.psx.psi"));
+    const auto probe_count = psi.probes.size();
+    const auto interval = psi.sampling_interval();
+
+    auto close = [](double a, double b) {
+        return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+    };
+
+    // Build (and save) the pyramid, then load it again
+    boost::filesystem::remove("./test.psx.psx");
+    auto built = pslib::v1_0::open_psx(loaded_psi, 16);
+    auto psx = pslib::v1_0::load_psx("./test.psx.psx");
+    if (psx.levels.size() != built.levels.size() ||
+        psx.block_count(0) != 94 ||
+        psx.block_count(psx.levels.size() - 1) != 1 ||
+        pslib::v1_0::psx_is_stale(psx, *loaded_psi)) {
+        std::cout << "Unexpected pyramid" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Compare range statistics against a full scan
+    const size_t windows[][ 2 ] = {
+        { 0, 1499 }, { 0, 0 }, { 3, 12 }, { 15, 16 }, { 16, 31 },
+        { 17, 1400 }, { 450, 1050 }, { 1000, 1499 }, { 1, 1498 },
+    };
+    for (const auto& window : windows) {
+        auto stats = pslib::v1_0::psx_statistics(
+            psx, loaded_psi, window[ 0 ] * interval, window[ 1 ] * interval);
+        for (size_t p = 0; p < probe_count; ++p) {
+            auto expected = pslib::v1_0::probe_statistics_t();
+            for (size_t i = window[ 0 ]; i <= window[ 1 ]; ++i) {
+                expected.add(samples.values[ i * probe_count + p ]);
+            }
+            const auto& c = stats[ p ].current;
+            const auto& v = stats[ p ].voltage;
+            if (c.count != expected.current.count ||
+                c.min != expected.current.min ||
+                c.max != expected.current.max ||
+                !close(c.mean(), expected.current.mean()) ||
+                !close(c.stddev(), expected.current.stddev()) ||
+                !close(c.rms(), expected.current.rms()) ||
+                v.count != expected.voltage.count ||
+                v.min != expected.voltage.min ||
+                v.max != expected.voltage.max ||
+                !close(v.mean(), expected.voltage.mean()) ||
+                !close(v.stddev(), expected.voltage.stddev())) {
+                std::cout << "Statistics of [" << window[ 0 ] << ", "
+                          << window[ 1 ] << "] differ for probe " << p
+                          << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // A changed psi makes the pyramid stale and open_psx rebuilds it
+    auto changed = *loaded_psi;
+    changed.checksum = 42;
+    const auto changed_psi = pslib::v1_0::shared_psi_t(std::move(changed));
+    if (!pslib::v1_0::psx_is_stale(psx, *changed_psi)) {
+        return EXIT_FAILURE;
+    }
+    try {
+        pslib::v1_0::psx_statistics(psx, changed_psi);
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+    auto rebuilt = pslib::v1_0::open_psx(changed_psi, 16);
+    if (pslib::v1_0::psx_is_stale(rebuilt, *changed_psi) ||
+        pslib::v1_0::load_psx("./test.psx.psx").checksum != 42) {
+        std::cout << "Stale pyramid not rebuilt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A corrupt block size makes the pyramid invalid and open_psx rebuilds
+    // it
+    {
+        std::fstream psx_file(
+            "./test.psx.psx", std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t zero = 0;
+        psx_file.seekp(4 + sizeof(uint32_t) + 3 * sizeof(uint64_t));
+        psx_file.write(reinterpret_cast< const char* >(&zero), sizeof(zero));
+    }
+    try {
+        pslib::v1_0::load_psx("./test.psx.psx");
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+    if (pslib::v1_0::open_psx(changed_psi, 16).block_size != 16 ||
+        pslib::v1_0::load_psx("./test.psx.psx").block_size != 16) {
+        std::cout << "Corrupt pyramid not rebuilt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Asking for another block size rebuilds the pyramid as well
+    if (pslib::v1_0::open_psx(changed_psi, 32).block_size != 32 ||
+        pslib::v1_0::load_psx("./test.psx.psx").block_size != 32) {
+        std::cout << "Pyramid with another block size reused" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A corrupt sample count is rejected before allocating the levels for it
+    {
+        std::fstream psx_file(
+            "./test.psx.psx", std::ios::binary | std::ios::in | std::ios::out);
+        const uint64_t huge = uint64_t(-1) - 1;
+        psx_file.seekp(4 + sizeof(uint32_t) + sizeof(uint64_t));
+        psx_file.write(reinterpret_cast< const char* >(&huge), sizeof(huge));
+    }
+    try {
+        pslib::v1_0::load_psx("./test.psx.psx");
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+    if (pslib::v1_0::open_psx(changed_psi, 32).data_count != 1500) {
+        std::cout << "Corrupt pyramid not rebuilt" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // A pyramid missing its upper levels can't cover the range
+    auto truncated = pslib::v1_0::load_psx("./test.psx.psx");
+    truncated.levels.resize(2);
+    try {
+        pslib::v1_0::psx_statistics(truncated, changed_psi);
+        std::cout << "Incomplete pyramid not rejected" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (std::runtime_error&) {
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.sample_arena.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.sample_arena");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.sample_arena");
+
+    auto loaded_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.sample_arena.psi"));
+
+    auto arena = pslib::v1_0::sample_arena(
+        pslib::v1_0::HUGE_PAGES::TRANSPARENT, 1024 * 1024);
+    size_t capacity = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        {
+            auto loaded = pslib::v1_0::load_samples(loaded_psi,
+                std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1),
+                &arena);
+            auto window = pslib::v1_0::load_samples(loaded_psi,
+                std::chrono::milliseconds(400), std::chrono::milliseconds(600),
+                &arena);
+            if (loaded.values != samples.values ||
+                loaded.events != samples.events ||
+                loaded.values.get_allocator().resource() != &arena ||
+                window.size() != 201 ||
+                window.values.front() != samples.values[ 400 * 2 ]) {
+                std::cout << "Samples differ" << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (arena.used() == 0 || arena.used() > arena.capacity()) {
+                std::cout << "Unexpected arena usage" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        // Loading again after a reset reuses the mapped blocks
+        if (i > 0 && arena.capacity() != capacity) {
+            std::cout << "Arena grew after reset" << std::endl;
+            return EXIT_FAILURE;
+        }
+        capacity = arena.capacity();
+        arena.reset();
+        if (arena.used() != 0) {
+            std::cout << "Arena not reset" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Parallel loading allocates only from the calling thread
+    auto parallel = pslib::v1_0::load_samples_parallel(loaded_psi,
+        std::chrono::nanoseconds(0), std::chrono::nanoseconds(-1), 2,
+        pslib::v1_0::psd_parallel_chunk_size, &arena);
+    if (parallel.values != samples.values ||
+        parallel.events != samples.events) {
+        std::cout << "Parallel samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,208 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.sample_view.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.sample_view");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.sample_view");
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.sample_view.psi");
+    const auto interval = loaded_psi.sampling_interval();
+
+    // Views match the samples handed out by at()
+    auto loaded = pslib::v1_0::load_samples(loaded_psi);
+    for (size_t i = 0; i < loaded.size(); i += 7) {
+        auto view = loaded[ i ];
+        auto sample = samples.at(i);
+        if (view.time != sample.time || view.values.size() != 2 ||
+            view.events.size() != 3 || view.values[ 1 ] != sample.values[ 1 ] ||
+            view.events[ 2 ] != sample.events[ 2 ]) {
+            std::cout << "View " << i << " differs" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Increment, decrement and random access
+    auto it = loaded.begin();
+    auto post = it++;
+    auto pre = ++it;
+    if (post != loaded.begin() || pre != loaded.begin() + 2 ||
+        it->time != 2 * interval || (it--)->time != 2 * interval ||
+        (--it)->time != 0 * interval || it[ 10 ].time != 10 * interval ||
+        loaded.end() - loaded.begin() != 1500 ||
+        std::distance(loaded.begin(), loaded.end()) != 1500 ||
+        *(loaded.end() - 1) != loaded[ 1499 ] || !(it < it + 1) ||
+        (5 + it)->values[ 0 ].current != 5.0) {
+        std::cout << "Unexpected iterator behaviour" << std::endl;
+        return EXIT_FAILURE;
+    }
+    size_t reversed = 0;
+    for (auto r = std::make_reverse_iterator(loaded.end());
+         r != std::make_reverse_iterator(loaded.begin()); ++r) {
+        if (r->time != (1499 - reversed) * interval) {
+            std::cout << "Unexpected reverse iteration" << std::endl;
+            return EXIT_FAILURE;
+        }
+        ++reversed;
+    }
+
+    // Standard algorithms
+    auto found = std::lower_bound(loaded.begin(), loaded.end(),
+        std::chrono::microseconds(742500),
+        [](const pslib::v1_0::sample_view_t& s, std::chrono::nanoseconds t) {
+            return s.time < t;
+        });
+    double sum = 0.0;
+    std::for_each(loaded.begin(), loaded.end(),
+        [&](const pslib::v1_0::sample_view_t& s) {
+            sum += s.values[ 0 ].current;
+        });
+    if (found - loaded.begin() != 743 || sum != 1499.0 * 1500.0 / 2.0 ||
+        !std::is_sorted(loaded.begin(), loaded.end(),
+            [](const pslib::v1_0::sample_view_t& lhs,
+                const pslib::v1_0::sample_view_t& rhs) {
+                return lhs.time < rhs.time;
+            })) {
+        std::cout << "Unexpected algorithm results" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Parallel algorithms
+    std::vector< double > currents(loaded.size());
+    std::for_each(std::execution::par_unseq, loaded.begin(), loaded.end(),
+        [&](const pslib::v1_0::sample_view_t& s) {
+            currents[ size_t(s.time / interval) ] = s.values[ 0 ].current;
+        });
+    auto parallel_sum = std::transform_reduce(std::execution::par_unseq,
+        loaded.begin(), loaded.end(), 0.0, std::plus<>(),
+        [](const pslib::v1_0::sample_view_t& s) {
+            return s.values[ 0 ].current;
+        });
+    for (size_t i = 0; i < currents.size(); ++i) {
+        if (currents[ i ] != double(i)) {
+            std::cout << "Unexpected parallel for_each" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (parallel_sum != 1499.0 * 1500.0 / 2.0) {
+        std::cout << "Unexpected parallel transform_reduce" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Slicing by index and time, also on a window not aligned to the
+    // sampling interval
+    auto window = pslib::v1_0::load_samples(loaded_psi,
+        std::chrono::microseconds(99500), std::chrono::milliseconds(300));
+    auto by_index = window.slice(10, 20);
+    auto by_time = window.slice(
+        std::chrono::microseconds(109900), std::chrono::milliseconds(129));
+    auto clamped = window.slice(200, 100);
+    if (window.begin()->time != 100 * interval || by_index.size() != 20 ||
+        by_index[ 0 ].time != 110 * interval ||
+        by_index[ 0 ] != window[ 10 ] ||
+        window.at(10).time != 110 * interval || by_time.size() != 20 ||
+        by_time.begin() != by_index.begin() ||
+        by_time.end() != by_index.end() || clamped.size() != 1 ||
+        window.slice(std::chrono::seconds(2), std::chrono::seconds(3))
+                .size() != 0) {
+        std::cout << "Unexpected slices" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+// Passing a psi_t where a shared_psi_t is expected must not copy silently
+static_assert(!std::is_convertible< const pslib::v1_0::psi_t&,
+                  pslib::v1_0::shared_psi_t >::value,
+    "shared_psi_t has to be created explicitly");
+
+int main(int argc, char* argv[])
+{
+    using namespace std::chrono_literals;
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.shared_psi.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.shared_psi");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.shared_psi");
+
+    auto shared_psi = pslib::v1_0::shared_psi_t(
+        pslib::v1_0::load_psi("./test.shared_psi.psi"));
+    if (*shared_psi != psi || shared_psi.probe_count() != 2 ||
+        shared_psi.record_size() != pslib::v1_0::sample_size(psi) ||
+        shared_psi.interval() != std::chrono::milliseconds(1) ||
+        shared_psi.exact_interval().count() != 1.0 / 1000.0 ||
+        shared_psi.psd_ranges().size() != 3) {
+        std::cout << "Unexpected derived values" << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        const auto& range = shared_psi.psd_ranges()[ i ];
+        if (range.first_sample != i * 500 || range.sample_count != 500 ||
+            range.size != 500 * pslib::v1_0::sample_size(psi)) {
+            std::cout << "Unexpected psd range " << i << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Windows cut from the recording all refer to the same psi
+    std::vector< pslib::v1_0::samples_t > windows;
+    for (size_t i = 0; i < 15; ++i) {
+        windows.push_back(pslib::v1_0::load_samples(shared_psi,
+            std::chrono::milliseconds(i * 100),
+            std::chrono::milliseconds(i * 100 + 99)));
+    }
+    auto soa = pslib::v1_0::load_soa_samples(shared_psi);
+    auto mapped = pslib::v1_0::map_samples(shared_psi);
+    auto reader = pslib::v1_0::sample_reader(shared_psi);
+    if (shared_psi.use_count() != 19 || &*windows[ 3 ].psi != &*shared_psi ||
+        &*soa.psi != &*shared_psi || &*mapped.psi != &*shared_psi ||
+        &reader.psi() != &*shared_psi) {
+        std::cout << "Psi isn't shared" << std::endl;
+        return EXIT_FAILURE;
+    }
+    {
+        auto envelope = pslib::v1_0::load_envelope(shared_psi, 10);
+        if (&*envelope.psi != &*shared_psi) {
+            std::cout << "Psi of the envelope isn't shared" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    for (size_t i = 0; i < windows.size(); ++i) {
+        const auto& window = windows[ i ];
+        if (window.size() != 100 || window[ 0 ].time != i * 100 * 1000000ns ||
+            window.values.front() != samples.values[ i * 100 * 2 ]) {
+            std::cout << "Window " << i << " differs" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Copies share the psi as well and compare equal to samples holding an
+    // equal (but not the same) psi
+    auto copy = windows[ 0 ];
+    auto reloaded = pslib::v1_0::load_samples(psi,
+        std::chrono::milliseconds(0), std::chrono::milliseconds(99));
+    if (&*copy.psi != &*shared_psi || copy != windows[ 0 ] ||
+        &*reloaded.psi == &*shared_psi || reloaded != windows[ 0 ]) {
+        std::cout << "Unexpected copies" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    windows.clear();
+    if (shared_psi.use_count() != 5) {
+        std::cout << "Psi still referenced by the windows" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
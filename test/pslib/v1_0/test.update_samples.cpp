@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) 2017, Daniel "Dadie" Korner
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. The source code and binary must not be used for military purposes
+ *
+ * THIS SOFTWARE IS PROVIDED BY Daniel "Dadie" Korner ''AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL Daniel "Dadie" Korner BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **/
+
+// StdLib
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Own
+#include <pslib/pslib_v1_0.h>
+
+int main(int argc, char* argv[])
+{
+
+    auto psi = pslib::v1_0::psi_t();
+    {
+        psi.filename = "./test.update_samples.psi";
+        psi.checksum = 0;
+        psi.sampling_rate = 1000;  // 1000 Hz
+        psi.sampling_count = 1500; // 1500 Samples
+
+        // Add Probes
+        for (int64_t i = 1; i <= 2; ++i) {
+            auto probe = pslib::v1_0::probe_t();
+            {
+                probe.id = i;
+                probe.port = i;
+                probe.kind = pslib::v1_0::PROBE_KIND::STD;
+                probe.current_min = std::numeric_limits< double >::quiet_NaN();
+                probe.current_max = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_min = std::numeric_limits< double >::quiet_NaN();
+                probe.voltage_max = std::numeric_limits< double >::quiet_NaN();
+            }
+            psi.probes.push_back(probe);
+        }
+
+        // Add PSDFiles with 500 Samples each
+        for (int64_t i = 0; i < 3; ++i) {
+            auto psd = pslib::v1_0::psd_t();
+            {
+                psd.id = i + 1;
+                psd.offset = i > 0 ? i * 500 + 1 : 0;
+                psd.data_count = 500;
+                psd.event_count = 0;
+            }
+            psi.psds.push_back(psd);
+        }
+    }
+
+    // write psi to file
+    pslib::v1_0::save_psi(psi, "./", "test.update_samples");
+
+    auto samples =
+        pslib::v1_0::samples_t(psi, std::chrono::nanoseconds(0), psi.length());
+    {
+        for (size_t i = 0; i < psi.sampling_count; ++i) {
+            for (size_t j = 0; j < psi.probes.size(); ++j) {
+                auto ds = pslib::v1_0::data_stream_t();
+                {
+                    ds.current = double(i) + double(j) / 10.0;
+                    ds.voltage = double(j) - double(i);
+                }
+                samples.values.push_back(ds);
+            }
+            for (size_t j = 0; j < (psi.probes.size() + 1); ++j) {
+                auto e = pslib::v1_0::event_t();
+                {
+                    e.data = uint16_t(i + j);
+                }
+                samples.events.push_back(e);
+            }
+        }
+    }
+
+    // write samples to psds
+    pslib::v1_0::save_samples(samples, "./", "test.update_samples");
+
+    auto loaded_psi = pslib::v1_0::load_psi("./test.update_samples.psi");
+    const auto probe_count = loaded_psi.probes.size();
+    auto differs = [&](const pslib::v1_0::psi_t& updated_psi) {
+        auto loaded = pslib::v1_0::load_samples(updated_psi);
+        return loaded.values != samples.values ||
+               loaded.events != samples.events;
+    };
+
+    // The pyramid and the event index on disk are patched to match a fresh
+    // build, the energy index is detected as stale by the revision
+    auto sidecars_patched = [&](const pslib::v1_0::psi_t& updated_psi) {
+        auto shared = pslib::v1_0::shared_psi_t(updated_psi);
+        auto psx = pslib::v1_0::load_psx("./test.update_samples.psx");
+        auto built = pslib::v1_0::build_psx(shared, 16);
+        if (pslib::v1_0::psx_is_stale(psx, updated_psi) ||
+            psx.levels.size() != built.levels.size()) {
+            return false;
+        }
+        for (size_t l = 0; l < psx.levels.size(); ++l) {
+            if (psx.levels[ l ].size() != built.levels[ l ].size() ||
+                std::memcmp(psx.levels[ l ].data(), built.levels[ l ].data(),
+                    sizeof(psx.levels[ l ][ 0 ]) * psx.levels[ l ].size()) !=
+                    0) {
+                return false;
+            }
+        }
+        auto index =
+            pslib::v1_0::load_event_index("./test.update_samples.pev");
+        return !pslib::v1_0::event_index_is_stale(index, updated_psi) &&
+               index.occurrences ==
+                   pslib::v1_0::build_event_index(shared).occurrences &&
+               pslib::v1_0::energy_index_is_stale(
+                   pslib::v1_0::load_energy_index(
+                       "./test.update_samples.pei"),
+                   updated_psi);
+    };
+
+    auto position = pslib::v1_0::psd_position(loaded_psi, 502);
+    if (position.psd != 1 ||
+        position.offset != 2 * pslib::v1_0::sample_size(loaded_psi) ||
+        pslib::v1_0::psd_position(loaded_psi, 1500).psd != 3) {
+        std::cout << "Unexpected psd position" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Sidecars built before the update
+    auto shared_loaded_psi = pslib::v1_0::shared_psi_t(loaded_psi);
+    pslib::v1_0::open_psx(shared_loaded_psi, 16);
+    pslib::v1_0::open_event_index(shared_loaded_psi);
+    pslib::v1_0::open_energy_index(shared_loaded_psi, 64);
+
+    // Patch 6 samples across the boundary of the first and second psd and
+    // mark all their events as occured
+    std::vector< pslib::v1_0::data_stream_t > values(6 * probe_count);
+    std::vector< pslib::v1_0::event_t > events(6 * (probe_count + 1));
+    for (size_t i = 0; i < 6; ++i) {
+        for (size_t j = 0; j < probe_count; ++j) {
+            values[ i * probe_count + j ].current = -1.0 * double(i);
+            values[ i * probe_count + j ].voltage = 42.0;
+        }
+        for (size_t j = 0; j < probe_count + 1; ++j) {
+            events[ i * (probe_count + 1) + j ].data = uint16_t(0x8000 | j);
+        }
+    }
+    pslib::v1_0::update_samples(
+        loaded_psi, 498, values.data(), events.data(), 6);
+    std::copy(values.begin(), values.end(),
+        samples.values.begin() + 498 * probe_count);
+    std::copy(events.begin(), events.end(),
+        samples.events.begin() + 498 * (probe_count + 1));
+
+    auto updated_psi = pslib::v1_0::load_psi("./test.update_samples.psi");
+    if (updated_psi.psds[ 0 ].event_count != 2 * 3 ||
+        updated_psi.psds[ 1 ].event_count != 4 * 3 ||
+        updated_psi.psds[ 2 ].event_count != 0 ||
+        differs(updated_psi)) {
+        std::cout << "Patched samples differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (updated_psi.revision != 1 || !sidecars_patched(updated_psi)) {
+        std::cout << "Sidecars not patched" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Reopened sidecars reflect the patched samples
+    auto shared_updated_psi = pslib::v1_0::shared_psi_t(updated_psi);
+    auto psx = pslib::v1_0::psx_statistics(
+        pslib::v1_0::open_psx(shared_updated_psi, 16), shared_updated_psi);
+    auto event_index = pslib::v1_0::open_event_index(shared_updated_psi);
+    auto energies = pslib::v1_0::indexed_probe_energy(
+        pslib::v1_0::open_energy_index(shared_updated_psi, 64),
+        shared_updated_psi);
+    auto streamed = pslib::v1_0::probe_energy(shared_updated_psi);
+    if (psx[ 0 ].current.min != -5.0 ||
+        event_index.occurrences !=
+            pslib::v1_0::build_event_index(shared_updated_psi).occurrences ||
+        std::fabs(energies[ 0 ].energy() - streamed[ 0 ].energy()) >
+            1e-9 * std::fabs(streamed[ 0 ].energy())) {
+        std::cout << "Stale sidecars after update" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Clear the occured flag of samples 499 to 501
+    pslib::v1_0::clear_events(updated_psi, std::chrono::microseconds(499000),
+        std::chrono::microseconds(501000), 0x8000);
+    for (size_t i = 499; i <= 501; ++i) {
+        for (size_t j = 0; j < probe_count + 1; ++j) {
+            samples.events[ i * (probe_count + 1) + j ].data = uint16_t(j);
+        }
+    }
+    auto cleared_psi = pslib::v1_0::load_psi("./test.update_samples.psi");
+    if (cleared_psi.psds[ 0 ].event_count != 3 ||
+        cleared_psi.psds[ 1 ].event_count != 2 * 3 ||
+        differs(cleared_psi) || !sidecars_patched(cleared_psi)) {
+        std::cout << "Cleared events differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Round trip of a loaded and modified window
+    auto window = pslib::v1_0::load_samples(cleared_psi,
+        std::chrono::microseconds(999500), std::chrono::milliseconds(1010));
+    for (auto& ds : window.values) {
+        ds.voltage = 0.0;
+    }
+    pslib::v1_0::update_samples(cleared_psi, window);
+    for (size_t i = 1000; i <= 1010; ++i) {
+        for (size_t j = 0; j < probe_count; ++j) {
+            samples.values[ i * probe_count + j ].voltage = 0.0;
+        }
+    }
+    // Events are unchanged, so the occurrences are patched in place
+    if (differs(cleared_psi) || cleared_psi.psds[ 2 ].event_count != 0 ||
+        !sidecars_patched(cleared_psi)) {
+        std::cout << "Updated window differs" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Out of range
+    try {
+        pslib::v1_0::update_samples(
+            cleared_psi, 1497, values.data(), events.data(), 6);
+        std::cout << "Out of range update succeeded" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (const std::runtime_error&) {
+    }
+
+    return EXIT_SUCCESS;
+}